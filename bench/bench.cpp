@@ -0,0 +1,251 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <list>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <GL/glew.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "gl++/mesh_optimizer.h"
+#include "gl++/program_cache.h"
+#include "gl++/shader.h"
+#include "gl++/vertex_buffer.h"
+
+using float_buffer = gl::vertex_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STATIC_DRAW>>;
+
+static std::vector<float> make_data(std::size_t size) {
+    std::vector<float> data(size);
+    std::iota(data.begin(), data.end(), 0.0f);
+    return data;
+}
+
+static void BM_construct_random_access(benchmark::State& state) {
+    auto data = make_data(state.range(0));
+    for(auto _ : state) {
+        float_buffer vbo(data.begin(), data.end());
+        benchmark::DoNotOptimize(vbo.handle());
+    }
+    state.SetBytesProcessed(state.iterations() * data.size() * sizeof(float));
+}
+BENCHMARK(BM_construct_random_access)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+static void BM_construct_input_iterator(benchmark::State& state) {
+    auto vector = make_data(state.range(0));
+    std::list<float> data(vector.begin(), vector.end());
+    for(auto _ : state) {
+        float_buffer vbo(data.begin(), data.end());
+        benchmark::DoNotOptimize(vbo.handle());
+    }
+    state.SetBytesProcessed(state.iterations() * data.size() * sizeof(float));
+}
+BENCHMARK(BM_construct_input_iterator)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+// range(0): elements written, range(1): offset into a buffer of 1 << 18 elements
+static void BM_modify(benchmark::State& state) {
+    float_buffer vbo(std::size_t(1 << 18));
+    auto data = make_data(state.range(0));
+    for(auto _ : state) {
+        vbo.modify(state.range(1), data.begin(), data.end());
+    }
+    glFinish();
+    state.SetBytesProcessed(state.iterations() * data.size() * sizeof(float));
+}
+BENCHMARK(BM_modify)->ArgsProduct({ { 16, 1024, 1 << 16 }, { 0, 1 << 17 } });
+
+// range(0): number of extend calls of 256 elements each
+static void BM_extend_growth(benchmark::State& state) {
+    auto data = make_data(256);
+    for(auto _ : state) {
+        float_buffer vbo(std::size_t(0));
+        for(std::int64_t i = 0; i < state.range(0); i++) {
+            vbo.extend(gl::span<const float>(data));
+        }
+        benchmark::DoNotOptimize(vbo.handle());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * data.size() * sizeof(float));
+}
+BENCHMARK(BM_extend_growth)->RangeMultiplier(4)->Range(4, 1024);
+
+static void BM_get(benchmark::State& state) {
+    auto data = make_data(state.range(0));
+    float_buffer vbo(data.begin(), data.end());
+    std::vector<float> buffer(data.size());
+    for(auto _ : state) {
+        vbo.get(0, buffer.begin(), buffer.end());
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetBytesProcessed(state.iterations() * data.size() * sizeof(float));
+}
+BENCHMARK(BM_get)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+static const char* vertex_shader_source = R"(
+#version 330 core
+layout(location = 0) in vec3 position;
+uniform mat4 transform;
+void main() {
+    gl_Position = transform * vec4(position, 1.0);
+}
+)";
+
+static const char* fragment_shader_source = R"(
+#version 330 core
+uniform vec4 tint;
+out vec4 color;
+void main() {
+    color = tint;
+}
+)";
+
+static void BM_program_compile_link(benchmark::State& state) {
+    for(auto _ : state) {
+        gl::shader_program program;
+        program.add_shader(vertex_shader_source, GL_VERTEX_SHADER);
+        program.add_shader(fragment_shader_source, GL_FRAGMENT_SHADER);
+        if(!program.link()) state.SkipWithError("failed to link");
+    }
+}
+BENCHMARK(BM_program_compile_link)->Unit(benchmark::kMillisecond);
+
+// warm startup: every build after the first loads the binary stored on disk
+static void BM_program_cache_startup(benchmark::State& state) {
+    auto directory = std::filesystem::temp_directory_path() / "gl++_program_cache_bench";
+    std::filesystem::remove_all(directory);
+    std::vector<gl::shader_source> sources {
+        { vertex_shader_source, GL_VERTEX_SHADER },
+        { fragment_shader_source, GL_FRAGMENT_SHADER }
+    };
+    gl::program_cache cache(directory.string());
+    {
+        gl::shader_program program;
+        cache.build(program, sources);
+    }
+    cache.reset_statistics();
+    for(auto _ : state) {
+        gl::shader_program program;
+        if(!cache.build(program, sources)) state.SkipWithError("failed to build");
+    }
+    state.counters["hits"] = cache.hits();
+    state.counters["misses"] = cache.misses();
+    std::filesystem::remove_all(directory);
+}
+BENCHMARK(BM_program_cache_startup)->Unit(benchmark::kMillisecond);
+
+// unindexed grid of size x size quads with the triangles shuffled, so every stage has work to do
+static void make_grid(std::int64_t size, std::vector<glm::vec2>& vertices, std::vector<GLuint>& indices) {
+    std::vector<std::array<glm::vec2, 3>> triangles;
+    for(std::int64_t y = 0; y < size; y++) {
+        for(std::int64_t x = 0; x < size; x++) {
+            auto fx = static_cast<float>(x), fy = static_cast<float>(y);
+            glm::vec2 p00(fx, fy), p10(fx + 1, fy), p01(fx, fy + 1), p11(fx + 1, fy + 1);
+            triangles.push_back({ p00, p10, p11 });
+            triangles.push_back({ p00, p11, p01 });
+        }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(42));
+    vertices.clear();
+    indices.clear();
+    for(const auto& triangle : triangles) {
+        for(const auto& p : triangle) {
+            indices.push_back(static_cast<GLuint>(vertices.size()));
+            vertices.push_back(p);
+        }
+    }
+}
+
+// CPU only. range(0): grid size, the mesh has 2 * range(0)^2 triangles
+static void BM_optimize_mesh(benchmark::State& state) {
+    std::vector<glm::vec2> vertices;
+    std::vector<GLuint> indices;
+    make_grid(state.range(0), vertices, indices);
+    gl::optimized_mesh<glm::vec2> mesh;
+    for(auto _ : state) {
+        mesh = gl::optimize_mesh<glm::vec2>(vertices, indices);
+        benchmark::DoNotOptimize(mesh.vertices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * indices.size() / 3);
+    state.counters["acmr_before"] = mesh.acmr_before;
+    state.counters["acmr_after"] = mesh.acmr_after;
+    state.counters["vertices"] = mesh.vertices.size();
+}
+BENCHMARK(BM_optimize_mesh)->RangeMultiplier(4)->Range(64, 1024)->Unit(benchmark::kMillisecond);
+
+static void BM_optimize_vertex_cache(benchmark::State& state) {
+    std::vector<glm::vec2> vertices;
+    std::vector<GLuint> indices;
+    make_grid(state.range(0), vertices, indices);
+    std::vector<GLuint> remap(vertices.size());
+    auto vertex_count = gl::generate_vertex_remap(remap, vertices.data(), vertices.size(), sizeof(glm::vec2));
+    for(auto& index : indices) index = remap[index];
+    for(auto _ : state) {
+        state.PauseTiming();
+        auto work = indices;
+        state.ResumeTiming();
+        gl::optimize_vertex_cache(work, vertex_count);
+        benchmark::DoNotOptimize(work.data());
+    }
+    state.SetItemsProcessed(state.iterations() * indices.size() / 3);
+}
+BENCHMARK(BM_optimize_vertex_cache)->RangeMultiplier(4)->Range(64, 1024)->Unit(benchmark::kMillisecond);
+
+// headless context on Mesa's surfaceless platform, so no display or real GPU is needed
+class headless_context {
+public:
+    headless_context() {
+        auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        m_display = get_platform_display ? get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr) : EGL_NO_DISPLAY;
+        if(m_display == EGL_NO_DISPLAY) m_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        EGLint major, minor;
+        if(eglInitialize(m_display, &major, &minor) == EGL_FALSE) {
+            throw std::runtime_error("failed to initialize EGL");
+        }
+        eglBindAPI(EGL_OPENGL_API);
+        EGLint attributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 4,
+            EGL_CONTEXT_MINOR_VERSION, 5,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+            EGL_NONE
+        };
+        m_context = eglCreateContext(m_display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+        if(m_context == EGL_NO_CONTEXT || eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context) == EGL_FALSE) {
+            throw std::runtime_error("failed to create EGL context");
+        }
+        // glewInit() would look for GLX, which a surfaceless context does not have
+        glewExperimental = GL_TRUE;
+        if(glewContextInit() != GLEW_OK) {
+            throw std::runtime_error("failed to initialize GLEW");
+        }
+    }
+    headless_context(const headless_context&) = delete;
+    headless_context& operator=(const headless_context&) = delete;
+    ~headless_context() {
+        eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(m_display, m_context);
+        eglTerminate(m_display);
+    }
+private:
+    EGLDisplay m_display;
+    EGLContext m_context;
+};
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if(benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+
+    headless_context context;
+    benchmark::AddCustomContext("GL_RENDERER", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    benchmark::AddCustomContext("GL_VERSION", reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
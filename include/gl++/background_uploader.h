@@ -0,0 +1,141 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_BACKGROUND_UPLOADER_H
+#define GL_BACKGROUND_UPLOADER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "gl++/direct_state_access.h"
+#include "gl++/vertex_buffer.h"
+
+namespace gl {
+    // result of background_uploader::upload(). the buffer can be used on the render thread once ready() is true.
+    template <class Traits>
+    class upload_ticket {
+        friend class background_uploader;
+    public:
+        using buffer_type = vertex_buffer<Traits>;
+    private:
+        struct state {
+            std::atomic<bool> done { false };
+            GLsync fence = nullptr;
+            std::optional<buffer_type> buffer;
+            ~state() {
+                if(fence) glDeleteSync(fence);
+            }
+        };
+    public:
+        upload_ticket() = default;
+        // never blocks. true once the worker has finished and the GPU has passed its fence.
+        [[nodiscard]] bool ready() {
+            if(!m_state || !m_state->done.load(std::memory_order_acquire)) return false;
+            if(m_state->fence == nullptr) return true;
+            auto status = glClientWaitSync(m_state->fence, 0, 0);
+            if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return false;
+            glDeleteSync(m_state->fence);
+            m_state->fence = nullptr;
+            return true;
+        }
+        // true once the worker has issued the upload, the GPU may still be copying
+        [[nodiscard]] bool done() const noexcept {
+            return m_state && m_state->done.load(std::memory_order_acquire);
+        }
+        // makes the calling context's GPU wait for the upload instead of the CPU.
+        // false without waiting if the worker has not issued the upload yet, as the fence does not exist until done().
+        [[nodiscard]] bool wait_gpu() {
+            if(!done()) return false;
+            // the fence is cleared only after the GPU has passed it
+            if(m_state->fence) glWaitSync(m_state->fence, 0, GL_TIMEOUT_IGNORED);
+            return true;
+        }
+        [[nodiscard]] buffer_type& get() {
+            return *m_state->buffer;
+        }
+        buffer_type take() {
+            return std::move(*m_state->buffer);
+        }
+    private:
+        std::shared_ptr<state> m_state;
+    };
+
+    // uploads buffers on a worker thread whose context shares objects with the render thread's.
+    // creating the shared context is up to the caller: make_current is called on the worker before
+    // the first job and release after the last one.
+    class background_uploader {
+    public:
+        background_uploader(std::function<void()> make_current, std::function<void()> release = {});
+        background_uploader(const background_uploader&) = delete;
+        background_uploader& operator=(const background_uploader&) = delete;
+        // finishes the queued jobs before returning
+        ~background_uploader();
+        template <class Traits>
+        upload_ticket<Traits> upload(std::vector<typename Traits::value_type> data) {
+            using value_type = typename Traits::value_type;
+            upload_ticket<Traits> ticket;
+            ticket.m_state = std::make_shared<typename upload_ticket<Traits>::state>();
+            enqueue([state = ticket.m_state, data = std::move(data)]() {
+                auto& buffer = state->buffer.emplace(data.size());
+                auto bytes = data.size() * sizeof(value_type);
+                if(bytes != 0) {
+                    // the storage is new, so the whole range can be invalidated and written without synchronization
+                    constexpr GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+                    void* mapped;
+                    if(direct_state_access()) {
+                        mapped = glMapNamedBufferRange(buffer.handle(), 0, bytes, access);
+                    } else {
+                        buffer.bind();
+                        mapped = glMapBufferRange(Traits::target, 0, bytes, access);
+                    }
+                    bool written = false;
+                    if(mapped) {
+                        std::memcpy(mapped, data.data(), bytes);
+                        written = direct_state_access() ? glUnmapNamedBuffer(buffer.handle()) : glUnmapBuffer(Traits::target);
+                    }
+                    // the data store can be lost while mapped, then fall back to a plain copy
+                    if(!written) buffer.modify(0, data.data(), data.size());
+                }
+                state->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                // without a fence the copy has to be complete before the ticket reports done
+                if(state->fence) glFlush();
+                else glFinish();
+                state->done.store(true, std::memory_order_release);
+            });
+            return ticket;
+        }
+        template <class Traits, class Iterator>
+        upload_ticket<Traits> upload(const Iterator& begin, const Iterator& end) {
+            return upload<Traits>(std::vector<typename Traits::value_type>(begin, end));
+        }
+        // blocks until every queued job has run on the worker
+        void flush();
+        [[nodiscard]] std::size_t pending() const;
+    private:
+        void enqueue(std::function<void()> job);
+        void run();
+    private:
+        std::function<void()> m_make_current;
+        std::function<void()> m_release;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::condition_variable m_idle;
+        std::deque<std::function<void()>> m_jobs;
+        std::size_t m_running;
+        bool m_stop;
+        std::thread m_thread;
+    };
+}
+
+#endif //GL_BACKGROUND_UPLOADER_H
@@ -0,0 +1,212 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_BUFFER_ARENA_H
+#define GL_BUFFER_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "gl++/direct_state_access.h"
+#include "gl++/profiler.h"
+#include "gl++/span.h"
+#include "gl++/state_cache.h"
+#include "gl++/vertex_buffer.h"
+
+namespace gl {
+    template <class T>
+    class arena_buffer;
+
+    // reserves large buffer objects and hands out sub-ranges of them.
+    // free space is kept in per-block free lists sorted by offset and coalesced on release.
+    class buffer_arena {
+    public:
+        using allocation_id = std::size_t;
+        static constexpr allocation_id invalid_allocation = ~std::size_t(0);
+        struct statistics {
+            std::size_t blocks;
+            std::size_t capacity;
+            std::size_t used;
+            std::size_t allocations;
+            std::size_t free_ranges;
+            std::size_t largest_free;
+            [[nodiscard]] double occupancy() const noexcept {
+                return capacity ? static_cast<double>(used) / capacity : 0.0;
+            }
+            [[nodiscard]] double fragmentation() const noexcept {
+                auto free = capacity - used;
+                return free ? 1.0 - static_cast<double>(largest_free) / free : 0.0;
+            }
+        };
+    public:
+        buffer_arena(GLenum target, GLenum usage, std::size_t block_size, std::size_t alignment = 4);
+        buffer_arena(const buffer_arena&) = delete;
+        buffer_arena& operator=(const buffer_arena&) = delete;
+        ~buffer_arena();
+        allocation_id allocate(std::size_t size, std::size_t alignment);
+        void deallocate(allocation_id id);
+        template <class T>
+        arena_buffer<T> allocate(std::size_t count) {
+            return arena_buffer<T>(*this, allocate(count * sizeof(T), std::lcm(sizeof(T), m_alignment)), count);
+        }
+        // moves live allocations of every block to its front with one copy per allocation.
+        // handles and offsets of allocations may change.
+        void defragment();
+        [[nodiscard]] GLuint handle(allocation_id id) const;
+        [[nodiscard]] std::size_t offset(allocation_id id) const;
+        [[nodiscard]] std::size_t size(allocation_id id) const;
+        [[nodiscard]] GLenum target() const noexcept;
+        [[nodiscard]] statistics stats() const noexcept;
+    private:
+        struct free_range {
+            std::size_t offset;
+            std::size_t size;
+        };
+        struct block {
+            GLuint handle;
+            std::size_t size;
+            std::vector<free_range> free_list;
+        };
+        struct record {
+            std::size_t block;
+            std::size_t offset;
+            std::size_t size;
+            std::size_t alignment;
+            bool live;
+        };
+        bool allocate_from(std::size_t block_index, record& r);
+        void release(std::size_t block_index, std::size_t offset, std::size_t size);
+        GLuint create_buffer(std::size_t size) const;
+    private:
+        GLenum m_target;
+        GLenum m_usage;
+        std::size_t m_block_size;
+        std::size_t m_alignment;
+        std::vector<block> m_blocks;
+        std::vector<record> m_records;
+        std::vector<allocation_id> m_free_records;
+    };
+
+    // typed sub-range of a buffer_arena. the arena must outlive it.
+    template <class T>
+    class arena_buffer {
+    public:
+        using value_type = T;
+    public:
+        arena_buffer(buffer_arena& arena, buffer_arena::allocation_id id, std::size_t size) : m_arena(&arena), m_id(id), m_size(size) {}
+        arena_buffer(const arena_buffer<T>&) = delete;
+        arena_buffer(arena_buffer<T>&& obj) noexcept : m_arena(obj.m_arena), m_id(obj.m_id), m_size(obj.m_size) {
+            obj.m_id = buffer_arena::invalid_allocation;
+        }
+        arena_buffer<T>& operator=(const arena_buffer<T>&) = delete;
+        arena_buffer<T>& operator=(arena_buffer<T>&& obj) noexcept {
+            if(this != &obj) {
+                if(m_id != buffer_arena::invalid_allocation) m_arena->deallocate(m_id);
+                m_arena = obj.m_arena;
+                m_id = obj.m_id;
+                m_size = obj.m_size;
+                obj.m_id = buffer_arena::invalid_allocation;
+            }
+            return *this;
+        }
+        ~arena_buffer() {
+            if(m_id != buffer_arena::invalid_allocation) m_arena->deallocate(m_id);
+        }
+        [[nodiscard]] GLuint handle() const {
+            return m_arena->handle(m_id);
+        }
+        // byte offset of the range in handle()
+        [[nodiscard]] std::size_t offset() const {
+            return m_arena->offset(m_id);
+        }
+        // index of the first element in handle(), usable as first or base vertex of draw calls
+        [[nodiscard]] std::size_t first() const {
+            return offset() / sizeof(value_type);
+        }
+        [[nodiscard]] std::size_t size() const noexcept {
+            return m_size;
+        }
+        void bind() {
+            current_state().bind_buffer(m_arena->target(), handle());
+        }
+        void unbind() {
+            current_state().bind_buffer(m_arena->target(), 0);
+        }
+        void vertex_pointer(GLuint location, GLboolean normalized, this_select_t this_, GLuint divisor = 0) {
+            current_state().bind_buffer(GL_ARRAY_BUFFER, handle());
+            vertex_attrib_pointer<value_type>(location, normalized, 0, offset(), divisor);
+        }
+        template <class U>
+        void vertex_pointer(GLuint location, GLboolean normalized, U value_t<value_type>::*member, GLuint divisor = 0) {
+            current_state().bind_buffer(GL_ARRAY_BUFFER, handle());
+            vertex_attrib_pointer<U>(location, normalized, sizeof(value_type), offset() + member_offset(member), divisor);
+        }
+        void modify(std::ptrdiff_t offset, const value_type* data, std::size_t size) {
+            if(offset >= m_size) return;
+            auto bytes = sizeof(value_type) * (size + offset > m_size ? m_size - offset : size);
+            auto start = this->offset() + offset * sizeof(value_type);
+            if(direct_state_access()) {
+                glNamedBufferSubData(handle(), start, bytes, data);
+            } else {
+                bind();
+                glBufferSubData(m_arena->target(), start, bytes, data);
+            }
+            profile_upload(bytes);
+        }
+        void modify(std::ptrdiff_t offset, span<const value_type> data) {
+            modify(offset, data.data(), data.size());
+        }
+        void modify(span<const value_type> data) {
+            modify(0, data.data(), data.size());
+        }
+        template <class Iterator>
+        void modify(std::ptrdiff_t offset, const Iterator& begin, const Iterator& end) {
+            std::vector<value_type> data(begin, end);
+            modify(offset, data.data(), data.size());
+        }
+        template <class Iterator>
+        void modify(const Iterator& begin, const Iterator& end) {
+            modify(0, begin, end);
+        }
+        void get(std::ptrdiff_t offset, value_type* data, std::size_t size) {
+            if(offset >= m_size) return;
+            auto bytes = sizeof(value_type) * (size + offset > m_size ? m_size - offset : size);
+            auto start = this->offset() + offset * sizeof(value_type);
+            if(direct_state_access()) {
+                glGetNamedBufferSubData(handle(), start, bytes, data);
+            } else {
+                bind();
+                glGetBufferSubData(m_arena->target(), start, bytes, data);
+            }
+            profile_read(bytes);
+        }
+        void get(std::ptrdiff_t offset, span<value_type> data) {
+            get(offset, data.data(), data.size());
+        }
+        void get(span<value_type> data) {
+            get(0, data.data(), data.size());
+        }
+        template <class Iterator>
+        void get(std::ptrdiff_t offset, const Iterator& begin, const Iterator& end) {
+            std::vector<value_type> data(std::distance(begin, end));
+            get(offset, data.data(), data.size());
+            std::copy(data.begin(), data.end(), begin);
+        }
+        template <class Iterator>
+        void get(const Iterator& begin, const Iterator& end) {
+            get(0, begin, end);
+        }
+    private:
+        buffer_arena* m_arena;
+        buffer_arena::allocation_id m_id;
+        std::size_t m_size;
+    };
+}
+
+#endif //GL_BUFFER_ARENA_H
@@ -0,0 +1,251 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_COMMAND_QUEUE_H
+#define GL_COMMAND_QUEUE_H
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "gl++/shader.h"
+#include "gl++/span.h"
+#include "gl++/vertex_array.h"
+#include "gl++/vertex_buffer.h"
+
+namespace gl {
+    class command_queue;
+
+    // bump allocator over reusable chunks. reset() keeps the chunks for the next recording.
+    class command_arena {
+    public:
+        explicit command_arena(std::size_t chunk_size = 64 * 1024);
+        command_arena(const command_arena&) = delete;
+        command_arena& operator=(const command_arena&) = delete;
+        void* allocate(std::size_t size, std::size_t alignment);
+        void reset() noexcept;
+        [[nodiscard]] std::size_t capacity() const noexcept;
+    private:
+        struct chunk {
+            std::unique_ptr<std::byte[]> data;
+            std::size_t size;
+        };
+        std::size_t m_chunk_size;
+        std::vector<chunk> m_chunks;
+        std::size_t m_chunk;
+        std::size_t m_offset;
+    };
+
+    namespace detail {
+        // storage of an object created on the GL thread. it is only destroyed there.
+        template <class T>
+        struct pending_slot {
+            std::atomic<bool> ready { false };
+            std::optional<T> object;
+        };
+    }
+
+    // placeholder for an object created by replaying a command_list.
+    // get() may only be called on the GL thread once ready() is true.
+    template <class T>
+    class pending {
+        friend class command_list;
+    public:
+        pending() = default;
+        [[nodiscard]] bool ready() const noexcept {
+            return m_slot && m_slot->ready.load(std::memory_order_acquire);
+        }
+        [[nodiscard]] T& get() const {
+            assert(m_slot && m_slot->object);
+            return *m_slot->object;
+        }
+        T* operator->() const {
+            return &get();
+        }
+        explicit operator bool() const noexcept {
+            return static_cast<bool>(m_slot);
+        }
+    private:
+        explicit pending(std::shared_ptr<detail::pending_slot<T>> slot) : m_slot(std::move(slot)) {}
+    private:
+        std::shared_ptr<detail::pending_slot<T>> m_slot;
+    };
+
+    // commands recorded on one thread. data passed to it is copied into the list's arena,
+    // so the caller's memory can be reused as soon as the call returns.
+    class command_list {
+        friend class command_queue;
+    public:
+        command_list(const command_list&) = delete;
+        command_list& operator=(const command_list&) = delete;
+        ~command_list();
+        // runs f() on the GL thread
+        template <class F>
+        void call(F&& f) {
+            using function_type = std::decay_t<F>;
+            auto p = new (m_arena.allocate(sizeof(function_type), alignof(function_type))) function_type(std::forward<F>(f));
+            m_commands.push_back(command { &invoke<function_type>, &destroy<function_type>, p });
+        }
+        // runs f(object) on the GL thread. the placeholder must be created by this list,
+        // or be ready before this list is submitted.
+        template <class T, class F>
+        void call(const pending<T>& target, F&& f) {
+            call([slot = target.m_slot, f = std::forward<F>(f)]() mutable {
+                assert(slot->object);
+                if(slot->object) f(*slot->object);
+            });
+        }
+        template <class Traits>
+        pending<vertex_buffer<Traits>> create_buffer(span<const typename Traits::value_type> data) {
+            auto copy = store(data);
+            return create<vertex_buffer<Traits>>([copy](std::optional<vertex_buffer<Traits>>& object) {
+                object.emplace(copy.data(), copy.size());
+            });
+        }
+        template <class Traits>
+        pending<vertex_buffer<Traits>> create_buffer(std::size_t size) {
+            return create<vertex_buffer<Traits>>([size](std::optional<vertex_buffer<Traits>>& object) {
+                object.emplace(size);
+            });
+        }
+        template <class Traits>
+        void modify(const pending<vertex_buffer<Traits>>& buffer, std::ptrdiff_t offset, span<const typename Traits::value_type> data) {
+            auto copy = store(data);
+            call(buffer, [offset, copy](vertex_buffer<Traits>& object) {
+                object.modify(offset, copy);
+            });
+        }
+        pending<vertex_array> create_vertex_array();
+        template <class Traits, class Member>
+        void vertex_pointer(const pending<vertex_array>& vao, const pending<vertex_buffer<Traits>>& buffer, GLuint location, GLboolean normalized, Member member, GLuint divisor = 0) {
+            call(vao, [slot = buffer.m_slot, location, normalized, member, divisor](vertex_array& object) {
+                assert(slot->object);
+                if(slot->object) slot->object->vertex_pointer(object, location, normalized, member, divisor);
+            });
+        }
+        // compiles and links on the GL thread. a program that fails to build is reset, so enabled() is false.
+        pending<shader_program> build_program(const std::vector<shader_source>& sources);
+        [[nodiscard]] std::size_t size() const noexcept;
+        [[nodiscard]] bool empty() const noexcept;
+    private:
+        struct command {
+            void (*invoke)(void*);
+            void (*destroy)(void*);
+            void* function;
+        };
+        explicit command_list(command_queue& queue);
+        template <class F>
+        static void invoke(void* f) {
+            (*static_cast<F*>(f))();
+        }
+        template <class F>
+        static void destroy(void* f) {
+            static_cast<F*>(f)->~F();
+        }
+        template <class T>
+        span<const T> store(span<const T> data) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if(data.empty()) return span<const T>();
+            auto p = static_cast<T*>(m_arena.allocate(data.size_bytes(), alignof(T)));
+            std::memcpy(p, data.data(), data.size_bytes());
+            return span<const T>(p, data.size());
+        }
+        struct stored_source {
+            std::string_view source;
+            GLenum type;
+        };
+        std::string_view store(std::string_view text);
+        template <class T, class Construct>
+        pending<T> create(Construct construct) {
+            std::shared_ptr<detail::pending_slot<T>> slot(new detail::pending_slot<T>(), slot_deleter<T> { m_queue });
+            call([slot, construct]() mutable {
+                construct(slot->object);
+                slot->ready.store(true, std::memory_order_release);
+            });
+            return pending<T>(std::move(slot));
+        }
+        template <class T>
+        struct slot_deleter {
+            command_queue* queue;
+            void operator()(detail::pending_slot<T>* slot) const;
+        };
+        void replay();
+        void reset() noexcept;
+    private:
+        command_queue* m_queue;
+        command_arena m_arena;
+        std::vector<command> m_commands;
+        command_list* m_next;
+        command_list* m_next_owned;
+    };
+
+    // hands out command lists to any thread and replays submitted lists on the GL thread.
+    // acquire() and submit() are lock-free. the queue must outlive every list and placeholder.
+    class command_queue {
+        friend class command_list;
+    public:
+        command_queue();
+        command_queue(const command_queue&) = delete;
+        command_queue& operator=(const command_queue&) = delete;
+        ~command_queue();
+        // an empty list, reused from the lists already replayed when possible
+        command_list& acquire();
+        void submit(command_list& list);
+        // GL thread only. replays up to max_lists lists in submission order and returns the number replayed.
+        // lists submitted by one thread replay in the order they were submitted.
+        std::size_t replay(std::size_t max_lists = ~std::size_t(0));
+        [[nodiscard]] std::size_t lists() const noexcept;
+    private:
+        struct disposal {
+            void* object;
+            void (*destroy)(void*);
+            disposal* next;
+        };
+        template <class T>
+        void dispose(detail::pending_slot<T>* slot) {
+            if(on_gl_thread()) {
+                delete slot;
+                return;
+            }
+            auto node = new disposal { slot, [](void* p) { delete static_cast<detail::pending_slot<T>*>(p); }, nullptr };
+            push<disposal, &disposal::next>(m_disposals, node, node);
+        }
+        [[nodiscard]] bool on_gl_thread() const noexcept;
+        // lock-free push of the chain first..last, linked through Next
+        template <class Node, Node* Node::*Next>
+        static void push(std::atomic<Node*>& head, Node* first, Node* last) {
+            auto next = head.load(std::memory_order_relaxed);
+            do {
+                last->*Next = next;
+            } while(!head.compare_exchange_weak(next, first, std::memory_order_release, std::memory_order_relaxed));
+        }
+    private:
+        std::atomic<command_list*> m_submitted;
+        std::atomic<command_list*> m_free;
+        std::atomic<command_list*> m_owned;
+        std::atomic<disposal*> m_disposals;
+        std::atomic<std::size_t> m_lists;
+        std::atomic<std::thread::id> m_gl_thread;
+        std::vector<command_list*> m_ready;
+        std::size_t m_ready_begin;
+    };
+
+    template <class T>
+    void command_list::slot_deleter<T>::operator()(detail::pending_slot<T>* slot) const {
+        queue->dispose(slot);
+    }
+}
+
+#endif //GL_COMMAND_QUEUE_H
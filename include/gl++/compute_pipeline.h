@@ -0,0 +1,85 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_COMPUTE_PIPELINE_H
+#define GL_COMPUTE_PIPELINE_H
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "gl++/memory_barrier.h"
+#include "gl++/shader.h"
+#include "gl++/uniform.h"
+#include "gl++/vertex_buffer.h"
+
+namespace gl {
+    struct dispatch_indirect_command {
+        GLuint num_groups_x;
+        GLuint num_groups_y;
+        GLuint num_groups_z;
+    };
+
+    enum class buffer_access {
+        read,
+        write,
+        read_write
+    };
+
+    // a linked compute program with its storage buffers. buffers are bound by the name of their
+    // shader storage block, and the barriers between dispatches are issued through current_barriers().
+    class compute_pipeline {
+    public:
+        explicit compute_pipeline(shader_program program);
+        // false if the program is not a linked compute program
+        [[nodiscard]] bool valid() const noexcept;
+        [[nodiscard]] const shader_program& program() const noexcept;
+        [[nodiscard]] const std::array<GLuint, 3>& work_group_size() const noexcept;
+        // binding point of a shader storage block, -1 if the program has no active block of that name
+        [[nodiscard]] GLint binding_point(name_hash block) const noexcept;
+        // false if the program has no active block of that name
+        bool bind(name_hash block, GLuint buffer, buffer_access access = buffer_access::read_write, GLintptr offset = 0, GLsizeiptr size = 0);
+        template <class Traits>
+        bool bind(name_hash block, const vertex_buffer<Traits>& buffer, buffer_access access = buffer_access::read_write) {
+            return bind(block, buffer.handle(), access);
+        }
+        bool unbind(name_hash block);
+        void dispatch(GLuint groups_x, GLuint groups_y = 1, GLuint groups_z = 1);
+        // enough work groups to cover the given number of invocations, the shader has to skip the excess ones
+        void dispatch_invocations(GLuint x, GLuint y = 1, GLuint z = 1);
+        // the group counts are read from the command at offset bytes into commands
+        void dispatch_indirect(GLuint commands, GLintptr offset = 0);
+        template <class Traits>
+        void dispatch_indirect(const vertex_buffer<Traits>& commands, std::size_t index = 0) {
+            static_assert(std::is_same_v<typename Traits::value_type, dispatch_indirect_command>);
+            dispatch_indirect(commands.handle(), index * sizeof(dispatch_indirect_command));
+        }
+    private:
+        struct block {
+            name_hash name;
+            GLuint index;
+            GLuint point;
+        };
+        struct binding {
+            GLuint point;
+            GLuint buffer;
+            buffer_access access;
+            GLintptr offset;
+            GLsizeiptr size;
+        };
+        void before_dispatch();
+        void after_dispatch();
+    private:
+        shader_program m_program;
+        std::array<GLuint, 3> m_work_group_size;
+        std::vector<block> m_blocks;
+        std::vector<binding> m_bindings;
+    };
+}
+
+#endif //GL_COMPUTE_PIPELINE_H
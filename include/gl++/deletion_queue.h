@@ -0,0 +1,79 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_DELETION_QUEUE_H
+#define GL_DELETION_QUEUE_H
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include <GL/glew.h>
+
+namespace gl {
+    // delays glDelete* of objects destroyed by gl++ until the GPU has finished the frame that used them.
+    // deferral is off by default. once enabled, call end_frame() after each frame
+    // and flush() before the context is destroyed.
+    class deletion_queue {
+    public:
+        deletion_queue() noexcept;
+        deletion_queue(const deletion_queue&) = delete;
+        deletion_queue& operator=(const deletion_queue&) = delete;
+        void set_deferred(bool deferred) noexcept;
+        [[nodiscard]] bool deferred() const noexcept;
+        // buffers retired with usage == 0 are never recycled
+        void retire_buffer(GLuint handle, std::size_t size, GLenum usage);
+        void retire_vertex_array(GLuint handle);
+        void retire_program(GLuint handle);
+        // a retired buffer whose frame has completed with the same size and usage, or 0
+        GLuint recycle_buffer(std::size_t size, GLenum usage);
+        // fences the objects retired since the last call and releases the completed frames
+        void end_frame();
+        // releases the completed frames without fencing the current one
+        void collect();
+        // deletes every retired and recycled object right now
+        void flush();
+        void set_recycle_limit(std::size_t limit);
+        [[nodiscard]] std::size_t recycle_limit() const noexcept;
+        [[nodiscard]] std::size_t pending() const noexcept;
+        [[nodiscard]] std::size_t recyclable() const noexcept;
+        [[nodiscard]] std::size_t recycled() const noexcept;
+        [[nodiscard]] std::size_t deleted() const noexcept;
+        void reset_statistics() noexcept;
+    private:
+        enum class object_type {
+            buffer, vertex_array, program
+        };
+        struct retired_object {
+            object_type type;
+            GLuint handle;
+            std::size_t size;
+            GLenum usage;
+        };
+        struct frame {
+            GLsync fence;
+            std::vector<retired_object> objects;
+        };
+        void retire(const retired_object& object);
+        void release(const retired_object& object);
+        void destroy(const retired_object& object);
+    private:
+        bool m_deferred;
+        std::vector<retired_object> m_current;
+        std::deque<frame> m_frames;
+        std::deque<retired_object> m_recyclable;
+        std::size_t m_recycle_limit;
+        std::size_t m_recycled;
+        std::size_t m_deleted;
+    };
+
+    deletion_queue& current_deletion_queue();
+
+    // delete immediately, or retire into the current thread's queue when deferral is on
+    void delete_buffer(GLuint handle, std::size_t size, GLenum usage);
+    void delete_vertex_array(GLuint handle);
+    void delete_program(GLuint handle);
+}
+
+#endif //GL_DELETION_QUEUE_H
@@ -0,0 +1,22 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_DIRECT_STATE_ACCESS_H
+#define GL_DIRECT_STATE_ACCESS_H
+
+#include <GL/glew.h>
+
+namespace gl {
+#ifdef GLPLUSPLUS_USE_DSA
+    inline bool direct_state_access() noexcept {
+        return GLEW_VERSION_4_5 || GLEW_ARB_direct_state_access;
+    }
+#else
+    constexpr bool direct_state_access() noexcept {
+        return false;
+    }
+#endif
+}
+
+#endif //GL_DIRECT_STATE_ACCESS_H
@@ -0,0 +1,180 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_DRAW_BATCH_H
+#define GL_DRAW_BATCH_H
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "gl++/primitive_type.h"
+#include "gl++/span.h"
+#include "gl++/stream_buffer.h"
+#include "gl++/vertex_array.h"
+#include "gl++/vertex_buffer.h"
+
+namespace gl {
+    struct draw_arrays_indirect_command {
+        GLuint count;
+        GLuint instance_count;
+        GLuint first;
+        GLuint base_instance;
+    };
+
+    struct draw_elements_indirect_command {
+        GLuint count;
+        GLuint instance_count;
+        GLuint first_index;
+        GLint base_vertex;
+        GLuint base_instance;
+    };
+
+    struct mesh_range {
+        GLuint first;
+        GLuint count;
+        GLint base_vertex;
+        bool indexed;
+    };
+
+    // packs meshes sharing Layout into one vertex and one index buffer, and draws every
+    // mesh recorded for a state bucket with one glMultiDraw*Indirect call.
+    template <class Layout, class Index = GLuint>
+    class draw_batch {
+    public:
+        using vertex_type = typename Layout::vertex_type;
+        using index_type = Index;
+        using bucket_type = std::uint64_t;
+        using vertex_buffer_type = vertex_buffer<buffer_trait<vertex_type, GL_ARRAY_BUFFER, GL_STATIC_DRAW>>;
+        using index_buffer_type = vertex_buffer<buffer_trait<index_type, GL_ELEMENT_ARRAY_BUFFER, GL_STATIC_DRAW>>;
+        // the commands of a frame go into a fenced region, so the GPU never waits on rewrites of the ones it still reads
+        using arrays_buffer_type = stream_buffer<buffer_trait<draw_arrays_indirect_command, GL_DRAW_INDIRECT_BUFFER, GL_STREAM_DRAW>>;
+        using elements_buffer_type = stream_buffer<buffer_trait<draw_elements_indirect_command, GL_DRAW_INDIRECT_BUFFER, GL_STREAM_DRAW>>;
+        static_assert(std::is_same_v<index_type, GLuint> || std::is_same_v<index_type, GLushort> || std::is_same_v<index_type, GLubyte>);
+    private:
+        struct bucket {
+            std::vector<draw_arrays_indirect_command> arrays;
+            std::vector<draw_elements_indirect_command> elements;
+            std::size_t arrays_offset;
+            std::size_t elements_offset;
+        };
+    public:
+        draw_batch() : m_vao(), m_vertices(std::size_t(0)), m_indices(std::size_t(0)),
+                m_arrays_commands(), m_elements_commands(), m_draw_calls(0) {
+            Layout::apply(m_vao);
+        }
+        mesh_range add_mesh(span<const vertex_type> vertices) {
+            mesh_range mesh { static_cast<GLuint>(m_vertices.size()), static_cast<GLuint>(vertices.size()), 0, false };
+            m_vertices.extend(vertices);
+            return mesh;
+        }
+        mesh_range add_mesh(span<const vertex_type> vertices, span<const index_type> indices) {
+            mesh_range mesh { static_cast<GLuint>(m_indices.size()), static_cast<GLuint>(indices.size()), static_cast<GLint>(m_vertices.size()), true };
+            m_vertices.extend(vertices);
+            m_indices.extend(indices);
+            return mesh;
+        }
+        void draw(bucket_type key, const mesh_range& mesh, GLuint instance_count = 1, GLuint base_instance = 0) {
+            auto& b = m_buckets[key];
+            if(mesh.indexed) {
+                b.elements.push_back(draw_elements_indirect_command { mesh.count, instance_count, mesh.first, mesh.base_vertex, base_instance });
+            } else {
+                b.arrays.push_back(draw_arrays_indirect_command { mesh.count, instance_count, mesh.first, base_instance });
+            }
+        }
+        // calls apply_state(key) before the draws of each bucket, in ascending key order
+        template <class StateFunction>
+        void submit(GLenum mode, StateFunction&& apply_state) {
+            m_arrays.clear();
+            m_elements.clear();
+            for(auto& [key, b] : m_buckets) {
+                b.arrays_offset = m_arrays.size();
+                b.elements_offset = m_elements.size();
+                m_arrays.insert(m_arrays.end(), b.arrays.begin(), b.arrays.end());
+                m_elements.insert(m_elements.end(), b.elements.begin(), b.elements.end());
+            }
+            auto arrays_base = upload(m_arrays_commands, m_arrays);
+            auto elements_base = upload(m_elements_commands, m_elements);
+
+            m_vao.bind();
+            m_vao.bind_vertex_buffer(0, m_vertices.handle(), 0, Layout::stride);
+            m_indices.bind();
+            m_draw_calls = 0;
+            for(auto& [key, b] : m_buckets) {
+                if(b.arrays.empty() && b.elements.empty()) continue;
+                apply_state(key);
+                if(!b.arrays.empty() && m_arrays_commands->valid()) {
+                    m_arrays_commands->bind();
+                    glMultiDrawArraysIndirect(mode, reinterpret_cast<void*>((arrays_base + b.arrays_offset) * sizeof(draw_arrays_indirect_command)),
+                                              b.arrays.size(), 0);
+                    m_draw_calls++;
+                }
+                if(!b.elements.empty() && m_elements_commands->valid()) {
+                    m_elements_commands->bind();
+                    glMultiDrawElementsIndirect(mode, gl_primitive_type<index_type>::value,
+                                                reinterpret_cast<void*>((elements_base + b.elements_offset) * sizeof(draw_elements_indirect_command)),
+                                                b.elements.size(), 0);
+                    m_draw_calls++;
+                }
+            }
+            // the regions written this frame are released once these draws have run
+            if(!m_arrays.empty()) m_arrays_commands->fence();
+            if(!m_elements.empty()) m_elements_commands->fence();
+            clear();
+        }
+        void submit(GLenum mode) {
+            submit(mode, [](bucket_type) {});
+        }
+        // drops the draws recorded for this frame, keeping the allocations
+        void clear() {
+            for(auto& [key, b] : m_buckets) {
+                b.arrays.clear();
+                b.elements.clear();
+            }
+        }
+        [[nodiscard]] std::size_t draw_calls() const noexcept {
+            return m_draw_calls;
+        }
+        [[nodiscard]] const vertex_array& array() const noexcept {
+            return m_vao;
+        }
+        [[nodiscard]] vertex_buffer_type& vertices() noexcept {
+            return m_vertices;
+        }
+        [[nodiscard]] index_buffer_type& indices() noexcept {
+            return m_indices;
+        }
+    private:
+        // copies the commands into the next region and returns the index of the first one in the buffer
+        template <class Command>
+        static std::size_t upload(std::optional<stream_buffer<buffer_trait<Command, GL_DRAW_INDIRECT_BUFFER, GL_STREAM_DRAW>>>& buffer,
+                                  const std::vector<Command>& commands) {
+            if(commands.empty()) return 0;
+            if(!buffer || commands.size() > buffer->size()) {
+                // regions are fixed in size, so a larger frame gets new storage and writes its commands once
+                buffer.emplace(power_of_two_growth{}(buffer ? buffer->size() : 0, commands.size()));
+            }
+            auto region = buffer->map();
+            if(region.size() < commands.size()) return 0;
+            std::memcpy(region.data(), commands.data(), commands.size() * sizeof(Command));
+            return buffer->offset();
+        }
+    private:
+        vertex_array m_vao;
+        vertex_buffer_type m_vertices;
+        index_buffer_type m_indices;
+        std::optional<arrays_buffer_type> m_arrays_commands;
+        std::optional<elements_buffer_type> m_elements_commands;
+        std::map<bucket_type, bucket> m_buckets;
+        std::vector<draw_arrays_indirect_command> m_arrays;
+        std::vector<draw_elements_indirect_command> m_elements;
+        std::size_t m_draw_calls;
+    };
+}
+
+#endif //GL_DRAW_BATCH_H
@@ -9,12 +9,88 @@
 #include <gl++/shader.h>
 #endif
 
+#ifndef GLPLUSPLUS_NO_SHADER_BATCH
+#include <gl++/shader_batch.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_SHADER_VARIANTS
+#include <gl++/shader_variants.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_COMPUTE_PIPELINE
+#include <gl++/compute_pipeline.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_TRANSFORM_FEEDBACK
+#include <gl++/transform_feedback.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_UNIFORM_BLOCK
+#include <gl++/uniform_block.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_PROGRAM_CACHE
+#include <gl++/program_cache.h>
+#endif
+
 #ifndef GLPLUSPLUS_NO_VERTEX_BUFFER
 #include <gl++/vertex_buffer.h>
 #endif
 
+#ifndef GLPLUSPLUS_NO_MESH_OPTIMIZER
+#include <gl++/mesh_optimizer.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_MESH_FILE
+#include <gl++/mesh_file.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_BUFFER_ARENA
+#include <gl++/buffer_arena.h>
+#endif
+
 #ifndef GLPLUSPLUS_NO_VERTEX_ARRAY
 #include <gl++/vertex_array.h>
 #endif
 
+#ifndef GLPLUSPLUS_NO_PACKED_ENCODE
+#include <gl++/packed_encode.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_VERTEX_LAYOUT
+#include <gl++/vertex_layout.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_DRAW_BATCH
+#include <gl++/draw_batch.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_STREAM_BUFFER
+#include <gl++/stream_buffer.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_INSTANCE_BUFFER
+#include <gl++/instance_buffer.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_READBACK
+#include <gl++/readback.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_DELETION_QUEUE
+#include <gl++/deletion_queue.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_BACKGROUND_UPLOADER
+#include <gl++/background_uploader.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_COMMAND_QUEUE
+#include <gl++/command_queue.h>
+#endif
+
+#ifndef GLPLUSPLUS_NO_PROFILER
+#include <gl++/profiler.h>
+#endif
+
 #endif //GL_GL_H
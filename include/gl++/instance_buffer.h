@@ -0,0 +1,146 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_INSTANCE_BUFFER_H
+#define GL_INSTANCE_BUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+
+#include <GL/glew.h>
+
+#include "gl++/deletion_queue.h"
+#include "gl++/direct_state_access.h"
+#include "gl++/profiler.h"
+#include "gl++/span.h"
+#include "gl++/state_cache.h"
+#include "gl++/vertex_array.h"
+#include "gl++/vertex_buffer.h"
+
+namespace gl {
+    // per-instance attribute stream rewritten every frame. update() orphans the storage instead of waiting
+    // for draws still reading the previous frame, and grows it in place, so the handle never changes and
+    // vertex arrays pointing at the buffer stay valid.
+    template <class T, GLenum Usage = GL_STREAM_DRAW, class GrowthPolicy = power_of_two_growth>
+    class instance_buffer {
+    public:
+        using value_type = T;
+        static constexpr GLenum buffer_target = GL_ARRAY_BUFFER;
+        static constexpr GLenum buffer_usage = Usage;
+    public:
+        explicit instance_buffer(std::size_t capacity = 0) : m_size(0), m_capacity(0), m_handle(0) {
+            if(direct_state_access()) {
+                glCreateBuffers(1, &m_handle);
+            } else {
+                glGenBuffers(1, &m_handle);
+                bind();
+            }
+            storage(capacity);
+        }
+        instance_buffer(const instance_buffer&) = delete;
+        instance_buffer(instance_buffer&& obj) noexcept : m_size(obj.m_size), m_capacity(obj.m_capacity), m_handle(obj.m_handle) {
+            obj.m_handle = 0;
+        }
+        instance_buffer& operator=(const instance_buffer&) = delete;
+        instance_buffer& operator=(instance_buffer&& obj) noexcept {
+            if(this != &obj) {
+                delete_buffer(m_handle, m_capacity * sizeof(value_type), buffer_usage);
+                m_size = obj.m_size;
+                m_capacity = obj.m_capacity;
+                m_handle = obj.m_handle;
+                obj.m_handle = 0;
+            }
+            return *this;
+        }
+        ~instance_buffer() {
+            delete_buffer(m_handle, m_capacity * sizeof(value_type), buffer_usage);
+            m_handle = 0;
+        }
+        void vertex_pointer(GLuint location, GLboolean normalized, this_select_t this_, GLuint divisor = 1) {
+            bind();
+            vertex_attrib_pointer<value_type>(location, normalized, 0, 0, divisor);
+        }
+        template <class U>
+        void vertex_pointer(GLuint location, GLboolean normalized, U value_t<value_type>::*member, GLuint divisor = 1) {
+            bind();
+            vertex_attrib_pointer<U>(location, normalized, sizeof(value_type), member_offset(member), divisor);
+        }
+        void vertex_pointer(const vertex_array& vao, GLuint location, GLboolean normalized, this_select_t this_, GLuint divisor = 1) {
+            if(direct_state_access()) {
+                vao.attribute<value_type>(location, normalized, 0, location);
+                vao.bind_vertex_buffer(location, m_handle, 0, sizeof(value_type));
+                vao.binding_divisor(location, divisor);
+            } else {
+                vao.bind();
+                vertex_pointer(location, normalized, this_, divisor);
+            }
+        }
+        template <class U>
+        void vertex_pointer(const vertex_array& vao, GLuint location, GLboolean normalized, U value_t<value_type>::*member, GLuint divisor = 1) {
+            if(direct_state_access()) {
+                vao.attribute<U>(location, normalized, member_offset(member), location);
+                vao.bind_vertex_buffer(location, m_handle, 0, sizeof(value_type));
+                vao.binding_divisor(location, divisor);
+            } else {
+                vao.bind();
+                vertex_pointer(location, normalized, member, divisor);
+            }
+        }
+        // replaces the instances of the frame. earlier contents are dropped even when the data is shorter.
+        void update(span<const value_type> data) {
+            if(data.size() > m_capacity) {
+                storage(std::max<std::size_t>(GrowthPolicy{}(m_capacity, data.size()), data.size()));
+            } else if(m_capacity > 0) {
+                storage(m_capacity);
+            }
+            m_size = data.size();
+            if(m_size == 0) return;
+            auto bytes = m_size * sizeof(value_type);
+            if(direct_state_access()) {
+                glNamedBufferSubData(m_handle, 0, bytes, data.data());
+            } else {
+                bind();
+                glBufferSubData(buffer_target, 0, bytes, data.data());
+            }
+            profile_upload(bytes);
+        }
+        void update(const value_type* data, std::size_t size) {
+            update(span<const value_type>(data, size));
+        }
+        // number of instances written by the last update, the instance count of the draw
+        [[nodiscard]] std::size_t size() const noexcept {
+            return m_size;
+        }
+        [[nodiscard]] std::size_t capacity() const noexcept {
+            return m_capacity;
+        }
+        [[nodiscard]] GLuint handle() const noexcept {
+            return m_handle;
+        }
+        void bind() {
+            current_state().bind_buffer(buffer_target, m_handle);
+        }
+        void unbind() {
+            current_state().bind_buffer(buffer_target, 0);
+        }
+    private:
+        // respecifying the storage of the same handle orphans the old one, which the driver frees after the draws using it
+        void storage(std::size_t capacity) {
+            if(capacity == 0) return;
+            if(direct_state_access()) {
+                glNamedBufferData(m_handle, capacity * sizeof(value_type), nullptr, buffer_usage);
+            } else {
+                bind();
+                glBufferData(buffer_target, capacity * sizeof(value_type), nullptr, buffer_usage);
+            }
+            m_capacity = capacity;
+        }
+    private:
+        std::size_t m_size;
+        std::size_t m_capacity;
+        GLuint m_handle;
+    };
+}
+
+#endif //GL_INSTANCE_BUFFER_H
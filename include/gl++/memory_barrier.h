@@ -0,0 +1,94 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_MEMORY_BARRIER_H
+#define GL_MEMORY_BARRIER_H
+
+#include <cstddef>
+#include <iterator>
+#include <unordered_map>
+
+#include <GL/glew.h>
+
+namespace gl {
+    // remembers which buffers shaders wrote through incoherent accesses (SSBOs) and issues glMemoryBarrier
+    // with only the bits a later use of one of those buffers needs. requires of one step are merged into one call.
+    class barrier_tracker {
+    public:
+        barrier_tracker() noexcept : m_required(0), m_issued(0), m_elided(0) {}
+        // buffer was written by a shader
+        void written(GLuint buffer) {
+            m_pending[buffer] = GL_ALL_BARRIER_BITS;
+        }
+        // buffer is about to be used in the way barrier covers, e.g. GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT to draw from it
+        void require(GLuint buffer, GLbitfield barrier) {
+            auto it = m_pending.find(buffer);
+            if(it != m_pending.end() && (it->second & barrier) != 0) {
+                m_required |= barrier;
+            } else {
+                m_elided++;
+            }
+        }
+        // issues the merged barrier of the requires since the last flush
+        void flush() {
+            if(m_required == 0) return;
+            glMemoryBarrier(m_required);
+            // the barrier is global, so it covers every pending write for these bits
+            for(auto it = m_pending.begin(); it != m_pending.end();) {
+                it->second &= ~m_required;
+                it = it->second == 0 ? m_pending.erase(it) : std::next(it);
+            }
+            m_required = 0;
+            m_issued++;
+        }
+        void use(GLuint buffer, GLbitfield barrier) {
+            require(buffer, barrier);
+            flush();
+        }
+        // the contents of from were copied into to, which replaces it
+        void moved(GLuint from, GLuint to) {
+            auto it = m_pending.find(from);
+            if(it == m_pending.end()) return;
+            auto bits = it->second;
+            m_pending.erase(it);
+            m_pending[to] |= bits;
+        }
+        // buffer was deleted, a new buffer may get its name
+        void forget(GLuint buffer) noexcept {
+            m_pending.erase(buffer);
+        }
+        // barrier bits a use of buffer would still need
+        [[nodiscard]] GLbitfield pending(GLuint buffer) const {
+            auto it = m_pending.find(buffer);
+            return it == m_pending.end() ? 0 : it->second;
+        }
+        // call after a raw glMemoryBarrier, or when tracked buffers are deleted with raw GL calls
+        void invalidate() noexcept {
+            m_pending.clear();
+            m_required = 0;
+        }
+        [[nodiscard]] std::size_t issued() const noexcept {
+            return m_issued;
+        }
+        [[nodiscard]] std::size_t elided() const noexcept {
+            return m_elided;
+        }
+        void reset_statistics() noexcept {
+            m_issued = 0;
+            m_elided = 0;
+        }
+    private:
+        std::unordered_map<GLuint, GLbitfield> m_pending;
+        GLbitfield m_required;
+        std::size_t m_issued;
+        std::size_t m_elided;
+    };
+
+    inline barrier_tracker& current_barriers() {
+        thread_local barrier_tracker tracker;
+        return tracker;
+    }
+}
+
+#endif //GL_MEMORY_BARRIER_H
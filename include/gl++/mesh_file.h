@@ -0,0 +1,190 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_MESH_FILE_H
+#define GL_MESH_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "gl++/primitive_type.h"
+#include "gl++/span.h"
+#include "gl++/vertex_buffer.h"
+#include "gl++/vertex_layout.h"
+
+namespace gl {
+    // binary mesh container, little endian:
+    //   header | attributes[attribute_count] | chunks[chunk_count] | chunk data
+    // every chunk is a contiguous piece of the vertex or index data, so it can be copied into its buffer as is.
+    struct mesh_attribute {
+        std::uint32_t location;
+        std::int32_t components;
+        std::uint32_t type;
+        std::uint32_t normalized;
+        std::uint32_t offset;
+        bool operator==(const mesh_attribute& other) const noexcept {
+            return location == other.location && components == other.components && type == other.type &&
+                   normalized == other.normalized && offset == other.offset;
+        }
+    };
+
+    struct mesh_chunk {
+        enum : std::uint32_t { vertices = 0, indices = 1 };
+        std::uint32_t kind;
+        std::uint32_t reserved;
+        std::uint64_t file_offset;
+        std::uint64_t size;
+        // byte offset inside the vertex or index buffer
+        std::uint64_t buffer_offset;
+    };
+
+    struct mesh_description {
+        std::uint32_t vertex_stride;
+        std::uint64_t vertex_count;
+        // 0 when the mesh has no indices
+        std::uint32_t index_type;
+        std::uint64_t index_count;
+        std::vector<mesh_attribute> attributes;
+    };
+
+    template <class Layout>
+    struct layout_attributes;
+    template <class Vertex, class... Attributes>
+    struct layout_attributes<vertex_layout<Vertex, Attributes...>> {
+        static std::vector<mesh_attribute> get() {
+            return { mesh_attribute {
+                    Attributes::location, Attributes::components, Attributes::type,
+                    Attributes::normalized, static_cast<std::uint32_t>(Attributes::offset) }... };
+        }
+    };
+
+    // writes vertices and indices split into chunks of at most chunk_size bytes (rounded down to whole elements)
+    bool write_mesh_file(const std::string& path, const mesh_description& description,
+                         const void* vertices, const void* indices, std::size_t chunk_size = 1 << 20);
+    template <class Layout, class Index = GLuint>
+    bool write_mesh_file(const std::string& path, span<const typename Layout::vertex_type> vertices,
+                         span<const Index> indices = {}, std::size_t chunk_size = 1 << 20) {
+        mesh_description description {
+            Layout::stride, vertices.size(),
+            indices.empty() ? 0u : static_cast<std::uint32_t>(gl_primitive_type<Index>::value), indices.size(),
+            layout_attributes<Layout>::get()
+        };
+        return write_mesh_file(path, description, vertices.data(), indices.data(), chunk_size);
+    }
+
+    // read-only mapping of a mesh file. chunk data is only paged in while it is uploaded.
+    class mesh_file {
+    public:
+        static constexpr std::uint32_t version = 1;
+        mesh_file();
+        explicit mesh_file(const std::string& path);
+        mesh_file(const mesh_file&) = delete;
+        mesh_file& operator=(const mesh_file&) = delete;
+        mesh_file(mesh_file&& obj) noexcept;
+        mesh_file& operator=(mesh_file&& obj) noexcept;
+        ~mesh_file();
+        // false if the file cannot be mapped or its header or chunk table is inconsistent
+        bool open(const std::string& path);
+        void close() noexcept;
+        [[nodiscard]] bool is_open() const noexcept;
+        [[nodiscard]] const mesh_description& description() const noexcept;
+        [[nodiscard]] const std::vector<mesh_chunk>& chunks() const noexcept;
+        [[nodiscard]] std::size_t vertex_bytes() const noexcept;
+        [[nodiscard]] std::size_t index_bytes() const noexcept;
+        template <class Layout>
+        [[nodiscard]] bool matches() const {
+            return is_open() && m_description.vertex_stride == Layout::stride && m_description.attributes == layout_attributes<Layout>::get();
+        }
+        [[nodiscard]] span<const std::byte> chunk_data(std::size_t chunk) const;
+        // copies one chunk into buffer through a mapped range of it, then lets the OS drop the chunk's pages.
+        // the range must not be in use by the GPU.
+        void upload(std::size_t chunk, GLuint buffer) const;
+    private:
+        void release_pages(const std::byte* data, std::size_t size) const;
+    private:
+        std::byte* m_data;
+        std::size_t m_size;
+        mesh_description m_description;
+        std::vector<mesh_chunk> m_chunks;
+    };
+
+    // GL buffers sized for a whole mesh_file, filled chunk by chunk when asked for.
+    // the file must stay open while chunks are loaded.
+    template <class Vertex, class Index = GLuint, GLenum Usage = GL_STATIC_DRAW>
+    class mesh_buffers {
+    public:
+        using vertex_buffer_type = vertex_buffer<buffer_trait<Vertex, GL_ARRAY_BUFFER, Usage>>;
+        using index_buffer_type = vertex_buffer<buffer_trait<Index, GL_ELEMENT_ARRAY_BUFFER, Usage>>;
+        static bool compatible(const mesh_file& file) noexcept {
+            const auto& description = file.description();
+            return file.is_open() && description.vertex_stride == sizeof(Vertex) &&
+                   (description.index_count == 0 || description.index_type == gl_primitive_type<Index>::value);
+        }
+        explicit mesh_buffers(const mesh_file& file)
+            : m_file(&file), m_vertices(std::size_t(file.description().vertex_count)),
+              m_indices(std::size_t(file.description().index_count)), m_loaded(file.chunks().size(), false), m_loaded_count(0) {}
+        // true once the chunk is in its buffer
+        bool load(std::size_t chunk) {
+            if(chunk >= m_loaded.size()) return false;
+            if(m_loaded[chunk]) return true;
+            auto kind = m_file->chunks()[chunk].kind;
+            m_file->upload(chunk, kind == mesh_chunk::vertices ? m_vertices.handle() : m_indices.handle());
+            m_loaded[chunk] = true;
+            m_loaded_count++;
+            return true;
+        }
+        void load_all() {
+            for(std::size_t i = 0; i < m_loaded.size(); i++) load(i);
+        }
+        // loads the chunks overlapping vertices [first, first + count) and returns how many were loaded now
+        std::size_t load_vertices(std::size_t first, std::size_t count) {
+            return load_range(mesh_chunk::vertices, first * sizeof(Vertex), count * sizeof(Vertex));
+        }
+        std::size_t load_indices(std::size_t first, std::size_t count) {
+            return load_range(mesh_chunk::indices, first * sizeof(Index), count * sizeof(Index));
+        }
+        [[nodiscard]] bool loaded(std::size_t chunk) const {
+            return chunk < m_loaded.size() && m_loaded[chunk];
+        }
+        [[nodiscard]] bool complete() const noexcept {
+            return m_loaded_count == m_loaded.size();
+        }
+        [[nodiscard]] std::size_t loaded_chunks() const noexcept {
+            return m_loaded_count;
+        }
+        vertex_buffer_type& vertices() noexcept {
+            return m_vertices;
+        }
+        index_buffer_type& indices() noexcept {
+            return m_indices;
+        }
+    private:
+        std::size_t load_range(std::uint32_t kind, std::size_t begin, std::size_t size) {
+            std::size_t count = 0;
+            const auto& chunks = m_file->chunks();
+            for(std::size_t i = 0; i < chunks.size(); i++) {
+                const auto& c = chunks[i];
+                if(c.kind != kind || m_loaded[i]) continue;
+                if(c.buffer_offset < begin + size && begin < c.buffer_offset + c.size) {
+                    load(i);
+                    count++;
+                }
+            }
+            return count;
+        }
+    private:
+        const mesh_file* m_file;
+        vertex_buffer_type m_vertices;
+        index_buffer_type m_indices;
+        std::vector<bool> m_loaded;
+        std::size_t m_loaded_count;
+    };
+}
+
+#endif //GL_MESH_FILE_H
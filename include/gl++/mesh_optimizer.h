@@ -0,0 +1,95 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_MESH_OPTIMIZER_H
+#define GL_MESH_OPTIMIZER_H
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "gl++/span.h"
+
+namespace gl {
+    // average number of vertices transformed per triangle with a FIFO post-transform cache of cache_size entries.
+    // 3 means no reuse at all, a regular grid approaches 0.5.
+    float average_cache_miss_ratio(span<const GLuint> indices, std::size_t vertex_count, std::size_t cache_size = 16);
+    // reorders triangles in place for the post-transform cache (Tom Forsyth's linear-speed algorithm)
+    void optimize_vertex_cache(span<GLuint> indices, std::size_t vertex_count);
+    // renumbers the vertices in the order the indices first use them. remap[old] is the new index,
+    // or ~0u for a vertex no triangle uses. returns the number of vertices used.
+    std::size_t optimize_vertex_fetch_remap(span<GLuint> remap, span<GLuint> indices);
+    // remap[i] is the first vertex whose bytes equal those of vertex i, numbered in first-occurrence order.
+    // returns the number of unique vertices.
+    std::size_t generate_vertex_remap(span<GLuint> remap, const void* vertices, std::size_t vertex_count, std::size_t vertex_size);
+
+    struct mesh_optimize_options {
+        bool deduplicate = true;
+        bool vertex_cache = true;
+        bool vertex_fetch = true;
+        bool narrow = true;
+        std::size_t cache_size = 16;
+    };
+
+    template <class Vertex>
+    struct optimized_mesh {
+        std::vector<Vertex> vertices;
+        // exactly one of the two is filled. narrowing needs every index to fit in GLushort.
+        std::vector<GLuint> indices;
+        std::vector<GLushort> short_indices;
+        float acmr_before;
+        float acmr_after;
+        [[nodiscard]] GLenum index_type() const noexcept {
+            return indices.empty() && !short_indices.empty() ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        }
+        [[nodiscard]] std::size_t index_count() const noexcept {
+            return indices.size() + short_indices.size();
+        }
+    };
+
+    // preprocessing before uploading a mesh to vertex_buffers. vertices are compared bytewise when deduplicating,
+    // so padding inside Vertex has to be zeroed for identical vertices to merge.
+    template <class Vertex>
+    optimized_mesh<Vertex> optimize_mesh(span<const Vertex> vertices, span<const GLuint> indices, const mesh_optimize_options& options = {}) {
+        static_assert(std::is_trivially_copyable_v<Vertex>);
+        optimized_mesh<Vertex> mesh;
+        mesh.indices.assign(indices.begin(), indices.end());
+        mesh.acmr_before = average_cache_miss_ratio(mesh.indices, vertices.size(), options.cache_size);
+
+        std::vector<GLuint> remap(vertices.size());
+        std::size_t vertex_count = vertices.size();
+        if(options.deduplicate) {
+            vertex_count = generate_vertex_remap(remap, vertices.data(), vertices.size(), sizeof(Vertex));
+            for(auto& index : mesh.indices) index = remap[index];
+            mesh.vertices.resize(vertex_count);
+            for(std::size_t i = 0; i < vertices.size(); i++) mesh.vertices[remap[i]] = vertices[i];
+        } else {
+            mesh.vertices.assign(vertices.begin(), vertices.end());
+        }
+        if(options.vertex_cache) {
+            optimize_vertex_cache(mesh.indices, vertex_count);
+        }
+        if(options.vertex_fetch) {
+            remap.resize(vertex_count);
+            vertex_count = optimize_vertex_fetch_remap(remap, mesh.indices);
+            std::vector<Vertex> fetched(vertex_count);
+            for(std::size_t i = 0; i < mesh.vertices.size(); i++) {
+                if(remap[i] != ~0u) fetched[remap[i]] = mesh.vertices[i];
+            }
+            mesh.vertices = std::move(fetched);
+        }
+        mesh.acmr_after = average_cache_miss_ratio(mesh.indices, mesh.vertices.size(), options.cache_size);
+
+        if(options.narrow && mesh.vertices.size() <= std::size_t(std::numeric_limits<GLushort>::max()) + 1 && !mesh.indices.empty()) {
+            mesh.short_indices.assign(mesh.indices.begin(), mesh.indices.end());
+            mesh.indices = std::vector<GLuint>();
+        }
+        return mesh;
+    }
+}
+
+#endif //GL_MESH_OPTIMIZER_H
@@ -0,0 +1,62 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_PACKED_ENCODE_H
+#define GL_PACKED_ENCODE_H
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "gl++/primitive_type.h"
+#include "gl++/span.h"
+
+namespace gl {
+    // bulk float -> packed attribute conversion. out must have the same number of elements as in.
+    // values are rounded to nearest even, normalized outputs clamp to their range and NaN encodes to the lower bound.
+    // x86 builds use SSE2, and F16C for halves when the CPU has it.
+    void encode(span<const float> in, span<half> out);
+    void encode(span<const float> in, span<snorm8> out);
+    void encode(span<const float> in, span<unorm8> out);
+    void encode(span<const float> in, span<snorm16> out);
+    void encode(span<const float> in, span<unorm16> out);
+    void encode(span<const glm::vec4> in, span<snorm_2_10_10_10> out);
+    void encode(span<const glm::vec4> in, span<unorm_2_10_10_10> out);
+
+    // interleaved components, in holds N floats per element of out
+    template <class T, std::size_t N>
+    void encode(span<const float> in, span<std::array<T, N>> out) {
+        static_assert(sizeof(std::array<T, N>) == sizeof(T) * N);
+        assert(in.size() == out.size() * N);
+        encode(in, span<T>(reinterpret_cast<T*>(out.data()), out.size() * N));
+    }
+
+    // e.g. vertex_buffer<...>(encode<std::array<half, 4>>(floats)) to upload packed data
+    template <class T>
+    std::vector<T> encode(span<const float> in) {
+        std::vector<T> out(in.size() / attribute_components<T>);
+        encode(in, span<T>(out));
+        return out;
+    }
+    template <class T>
+    std::vector<T> encode(span<const glm::vec4> in) {
+        std::vector<T> out(in.size());
+        encode(in, span<T>(out));
+        return out;
+    }
+
+    float decode(half value);
+    float decode(snorm8 value);
+    float decode(unorm8 value);
+    float decode(snorm16 value);
+    float decode(unorm16 value);
+    glm::vec4 decode(snorm_2_10_10_10 value);
+    glm::vec4 decode(unorm_2_10_10_10 value);
+}
+
+#endif //GL_PACKED_ENCODE_H
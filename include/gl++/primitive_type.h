@@ -5,10 +5,36 @@
 #ifndef GL_PRIMITIVE_TYPE_H
 #define GL_PRIMITIVE_TYPE_H
 
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
 #include <GL/gl.h>
 #include <glm/glm.hpp>
 
 namespace gl {
+    // packed attribute types. they are plain storage, use packed_encode.h to fill them from floats.
+    // IEEE 754 binary16
+    struct half {
+        std::uint16_t bits;
+    };
+    // integer read by the shader as a float in [-1, 1] (signed) or [0, 1] (unsigned)
+    template <class T>
+    struct normalized {
+        T value;
+    };
+    using snorm8 = normalized<GLbyte>;
+    using unorm8 = normalized<GLubyte>;
+    using snorm16 = normalized<GLshort>;
+    using unorm16 = normalized<GLushort>;
+    // four normalized components in one word: x, y and z in 10 bits each from the lowest bit, w in the top 2 bits
+    struct snorm_2_10_10_10 {
+        GLuint bits;
+    };
+    struct unorm_2_10_10_10 {
+        GLuint bits;
+    };
+
     template <class T>
     struct non_value {};
     template <class T>
@@ -61,6 +87,65 @@ namespace gl {
         using type = T;
         inline static constexpr GLenum value = gl_primitive_type<T>::value;
     };
+    // matrices are passed as one attribute per column
+    template <glm::length_t C, glm::length_t R, class T, glm::qualifier Q>
+    struct gl_primitive_type<glm::mat<C, R, T, Q>> {
+        using type = T;
+        inline static constexpr GLenum value = gl_primitive_type<T>::value;
+    };
+    template <>
+    struct gl_primitive_type<half> {
+        using type = half;
+        inline static constexpr GLenum value = GL_HALF_FLOAT;
+    };
+    template <class T>
+    struct gl_primitive_type<normalized<T>> {
+        using type = normalized<T>;
+        inline static constexpr GLenum value = gl_primitive_type<T>::value;
+    };
+    template <>
+    struct gl_primitive_type<snorm_2_10_10_10> {
+        using type = snorm_2_10_10_10;
+        inline static constexpr GLenum value = GL_INT_2_10_10_10_REV;
+    };
+    template <>
+    struct gl_primitive_type<unorm_2_10_10_10> {
+        using type = unorm_2_10_10_10;
+        inline static constexpr GLenum value = GL_UNSIGNED_INT_2_10_10_10_REV;
+    };
+    // vectors of packed types, e.g. std::array<half, 4>
+    template <class T, std::size_t N>
+    struct gl_primitive_type<std::array<T, N>> {
+        using type = typename gl_primitive_type<T>::type;
+        inline static constexpr GLenum value = gl_primitive_type<T>::value;
+    };
+
+    // how an attribute of type T is passed to glVertexAttrib*Pointer / glVertexAttrib*Format
+    template <class T>
+    inline constexpr bool is_packed_attribute_v =
+            std::is_same_v<T, snorm_2_10_10_10> || std::is_same_v<T, unorm_2_10_10_10>;
+    template <class T>
+    inline constexpr bool is_normalized_attribute_v = is_packed_attribute_v<T>;
+    template <class T>
+    inline constexpr bool is_normalized_attribute_v<normalized<T>> = true;
+    // attributes the shader reads as float, which go through the non-I/L entry points
+    template <class T>
+    inline constexpr bool is_float_attribute_v =
+            std::is_same_v<T, GLfloat> || std::is_same_v<T, half> || is_normalized_attribute_v<T>;
+    template <class T>
+    inline constexpr GLuint attribute_columns = 1;
+    template <glm::length_t C, glm::length_t R, class T, glm::qualifier Q>
+    inline constexpr GLuint attribute_columns<glm::mat<C, R, T, Q>> = C;
+    template <class T>
+    inline constexpr GLint attribute_components =
+            is_packed_attribute_v<std::remove_cv_t<typename gl_primitive_type<T>::type>> ? 4 :
+            static_cast<GLint>(sizeof(T) / sizeof(typename gl_primitive_type<T>::type) / attribute_columns<T>);
+    // locations taken by one column, double vectors of more than two components take two
+    template <class T>
+    inline constexpr GLuint attribute_column_locations =
+            std::is_same_v<std::remove_cv_t<typename gl_primitive_type<T>::type>, GLdouble> && attribute_components<T> > 2 ? 2 : 1;
+    template <class T>
+    inline constexpr GLuint attribute_locations = attribute_columns<T> * attribute_column_locations<T>;
 }
 
 #endif //GL_PRIMITIVE_TYPE_H
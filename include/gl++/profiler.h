@@ -0,0 +1,130 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_PROFILER_H
+#define GL_PROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef GLPLUSPLUS_PROFILE
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+#endif
+
+#include <GL/glew.h>
+
+namespace gl {
+    struct profile_counters {
+        std::size_t uploaded_bytes;
+        std::size_t read_bytes;
+        std::size_t program_binds;
+        std::size_t shader_compiles;
+        std::size_t program_links;
+    };
+
+    struct profile_zone_record {
+        const char* name;
+        std::uint64_t frame;
+        std::uint32_t depth;
+        // GL_TIMESTAMP values in nanoseconds
+        std::uint64_t begin;
+        std::uint64_t end;
+    };
+
+#ifdef GLPLUSPLUS_PROFILE
+    // GPU timing zones on GL_TIMESTAMP queries. results are read back in end_frame()
+    // once they are latency frames old and available, so the CPU never waits for them.
+    // zones nest, which GL_TIME_ELAPSED queries cannot.
+    class profiler {
+    public:
+        explicit profiler(std::uint64_t latency = 3) noexcept;
+        profiler(const profiler&) = delete;
+        profiler& operator=(const profiler&) = delete;
+        // names must outlive the profiler, string literals are expected
+        std::size_t begin_zone(const char* name);
+        void end_zone(std::size_t zone);
+        void end_frame();
+        [[nodiscard]] std::uint64_t frame() const noexcept;
+        [[nodiscard]] const std::vector<profile_zone_record>& zones() const noexcept;
+        [[nodiscard]] profile_counters& counters() noexcept;
+        [[nodiscard]] const profile_counters& counters() const noexcept;
+        void write_chrome_trace(std::ostream& stream) const;
+        bool write_chrome_trace(const std::string& path) const;
+        // drops the recorded zones and counters. zones still in flight are kept.
+        void reset();
+        // deletes every query object, call it before the context is destroyed
+        void release();
+    private:
+        struct pending_zone {
+            profile_zone_record record;
+            GLuint queries[2];
+            bool closed;
+        };
+        GLuint acquire_query();
+    private:
+        std::uint64_t m_latency;
+        std::uint64_t m_frame;
+        std::uint32_t m_depth;
+        std::size_t m_first_zone;
+        std::deque<pending_zone> m_pending;
+        std::vector<GLuint> m_queries;
+        std::vector<profile_zone_record> m_zones;
+        profile_counters m_counters;
+    };
+
+    profiler& current_profiler();
+
+    class profile_zone {
+    public:
+        explicit profile_zone(const char* name) : m_zone(current_profiler().begin_zone(name)) {}
+        profile_zone(const profile_zone&) = delete;
+        profile_zone& operator=(const profile_zone&) = delete;
+        ~profile_zone() {
+            current_profiler().end_zone(m_zone);
+        }
+    private:
+        std::size_t m_zone;
+    };
+
+    inline void profile_upload(std::size_t bytes) {
+        current_profiler().counters().uploaded_bytes += bytes;
+    }
+    inline void profile_read(std::size_t bytes) {
+        current_profiler().counters().read_bytes += bytes;
+    }
+    inline void profile_program_bind() {
+        current_profiler().counters().program_binds++;
+    }
+    inline void profile_shader_compile() {
+        current_profiler().counters().shader_compiles++;
+    }
+    inline void profile_program_link() {
+        current_profiler().counters().program_links++;
+    }
+#else
+    class profile_zone {
+    public:
+        constexpr explicit profile_zone(const char*) noexcept {}
+    };
+
+    constexpr void profile_upload(std::size_t) noexcept {}
+    constexpr void profile_read(std::size_t) noexcept {}
+    constexpr void profile_program_bind() noexcept {}
+    constexpr void profile_shader_compile() noexcept {}
+    constexpr void profile_program_link() noexcept {}
+#endif
+}
+
+#ifdef GLPLUSPLUS_PROFILE
+#define GLPLUSPLUS_PROFILE_CONCAT_IMPL(a, b) a##b
+#define GLPLUSPLUS_PROFILE_CONCAT(a, b) GLPLUSPLUS_PROFILE_CONCAT_IMPL(a, b)
+#define GLPLUSPLUS_PROFILE_ZONE(name) ::gl::profile_zone GLPLUSPLUS_PROFILE_CONCAT(glplusplus_profile_zone_, __LINE__)(name)
+#else
+#define GLPLUSPLUS_PROFILE_ZONE(name) static_cast<void>(0)
+#endif
+
+#endif //GL_PROFILER_H
@@ -0,0 +1,39 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_PROGRAM_CACHE_H
+#define GL_PROGRAM_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "gl++/shader.h"
+
+namespace gl {
+    // stores linked program binaries on disk, keyed by the sources and the driver identity.
+    class program_cache {
+    public:
+        explicit program_cache(std::string directory);
+        bool build(shader_program& program, const std::vector<shader_source>& sources);
+        [[nodiscard]] const std::string& directory() const noexcept;
+        [[nodiscard]] std::size_t hits() const noexcept;
+        [[nodiscard]] std::size_t misses() const noexcept;
+        [[nodiscard]] std::size_t rejected() const noexcept;
+        void reset_statistics() noexcept;
+    private:
+        [[nodiscard]] std::string path(const std::vector<shader_source>& sources) const;
+        bool load(shader_program& program, const std::string& path);
+        void store(const shader_program& program, const std::string& path) const;
+    private:
+        std::string m_directory;
+        std::size_t m_hits;
+        std::size_t m_misses;
+        std::size_t m_rejected;
+    };
+}
+
+#endif //GL_PROGRAM_CACHE_H
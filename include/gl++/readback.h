@@ -0,0 +1,127 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_READBACK_H
+#define GL_READBACK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "gl++/direct_state_access.h"
+#include "gl++/memory_barrier.h"
+#include "gl++/profiler.h"
+#include "gl++/span.h"
+#include "gl++/state_cache.h"
+#include "gl++/vertex_buffer.h"
+
+namespace gl {
+    // result of get_async(). the copy into the staging buffer is queued on the GPU,
+    // and the data is mapped out once the fence has signaled.
+    template <class T>
+    class readback {
+    public:
+        using value_type = T;
+        using staging_type = vertex_buffer<buffer_trait<T, GL_PIXEL_PACK_BUFFER, GL_STREAM_READ>>;
+    public:
+        readback(GLuint source, std::size_t offset, std::size_t size) : m_staging(size), m_fence(nullptr) {
+            if(size == 0) return;
+            current_barriers().use(source, GL_BUFFER_UPDATE_BARRIER_BIT);
+            if(direct_state_access()) {
+                glCopyNamedBufferSubData(source, m_staging.handle(), offset * sizeof(value_type), 0, size * sizeof(value_type));
+            } else {
+                current_state().bind_buffer(GL_COPY_READ_BUFFER, source);
+                m_staging.bind();
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_PIXEL_PACK_BUFFER, offset * sizeof(value_type), 0, size * sizeof(value_type));
+                m_staging.unbind();
+            }
+            m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glFlush();
+        }
+        readback(const readback<T>&) = delete;
+        readback(readback<T>&& obj) noexcept : m_staging(std::move(obj.m_staging)), m_fence(obj.m_fence) {
+            obj.m_fence = nullptr;
+        }
+        readback<T>& operator=(const readback<T>&) = delete;
+        readback<T>& operator=(readback<T>&& obj) noexcept {
+            if(this != &obj) {
+                if(m_fence) glDeleteSync(m_fence);
+                m_staging = std::move(obj.m_staging);
+                m_fence = obj.m_fence;
+                obj.m_fence = nullptr;
+            }
+            return *this;
+        }
+        ~readback() {
+            if(m_fence) glDeleteSync(m_fence);
+        }
+        [[nodiscard]] std::size_t size() const noexcept {
+            return m_staging.size();
+        }
+        [[nodiscard]] bool ready() {
+            if(m_fence == nullptr) return true;
+            auto status = glClientWaitSync(m_fence, 0, 0);
+            if(status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+                glDeleteSync(m_fence);
+                m_fence = nullptr;
+            }
+            return m_fence == nullptr;
+        }
+        bool wait_for(std::chrono::nanoseconds timeout) {
+            if(m_fence == nullptr) return true;
+            auto status = glClientWaitSync(m_fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout.count());
+            if(status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+                glDeleteSync(m_fence);
+                m_fence = nullptr;
+            }
+            return m_fence == nullptr;
+        }
+        void wait() {
+            while(!wait_for(std::chrono::milliseconds(1)));
+        }
+        void get(span<value_type> data) {
+            wait();
+            auto size = std::min(data.size(), this->size());
+            if(size == 0) return;
+            const void* mapped;
+            if(direct_state_access()) {
+                mapped = glMapNamedBufferRange(m_staging.handle(), 0, size * sizeof(value_type), GL_MAP_READ_BIT);
+            } else {
+                m_staging.bind();
+                mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size * sizeof(value_type), GL_MAP_READ_BIT);
+            }
+            if(mapped) std::memcpy(data.data(), mapped, size * sizeof(value_type));
+            profile_read(size * sizeof(value_type));
+            if(direct_state_access()) {
+                glUnmapNamedBuffer(m_staging.handle());
+            } else {
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                m_staging.unbind();
+            }
+        }
+        [[nodiscard]] std::vector<value_type> get() {
+            std::vector<value_type> data(size());
+            get(span<value_type>(data));
+            return data;
+        }
+    private:
+        staging_type m_staging;
+        GLsync m_fence;
+    };
+
+    template <class Traits>
+    readback<typename Traits::value_type> get_async(const vertex_buffer<Traits>& buffer, std::size_t offset, std::size_t size) {
+        if(offset >= buffer.size()) return readback<typename Traits::value_type>(buffer.handle(), 0, 0);
+        return readback<typename Traits::value_type>(buffer.handle(), offset, std::min(size, buffer.size() - offset));
+    }
+    template <class Traits>
+    readback<typename Traits::value_type> get_async(const vertex_buffer<Traits>& buffer) {
+        return get_async(buffer, 0, buffer.size());
+    }
+}
+
+#endif //GL_READBACK_H
@@ -5,11 +5,60 @@
 #ifndef GL_SHADER_H
 #define GL_SHADER_H
 
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 #include <GL/glew.h>
 
+#include "gl++/span.h"
+#include "gl++/uniform.h"
+
 namespace gl {
+    struct shader_source {
+        std::string source;
+        GLenum type;
+    };
+
+    // value of a SPIR-V specialization constant, the bits of a 32 bit scalar
+    struct specialization_constant {
+        GLuint id;
+        GLuint value;
+        template <class T>
+        static specialization_constant of(GLuint id, T value) noexcept {
+            static_assert(std::is_arithmetic_v<T> && sizeof(T) <= sizeof(GLuint), "specialization constants are 32 bit scalars");
+            if constexpr(std::is_same_v<T, bool>) {
+                return specialization_constant { id, value ? 1u : 0u };
+            } else {
+                GLuint bits = 0;
+                std::memcpy(&bits, &value, sizeof(T));
+                return specialization_constant { id, bits };
+            }
+        }
+        bool operator==(const specialization_constant& other) const noexcept {
+            return id == other.id && value == other.value;
+        }
+        bool operator<(const specialization_constant& other) const noexcept {
+            return id != other.id ? id < other.id : value < other.value;
+        }
+    };
+
+    struct program_resource {
+        std::string name;
+        name_hash hash;
+        GLenum program_interface;
+        GLuint index;
+        // location of uniforms and inputs, binding point of blocks
+        GLint location;
+        GLenum type;
+        GLint array_size;
+        GLint block_index;
+        GLint offset;
+        GLint data_size;
+    };
+
     class shader_program {
     public:
         shader_program();
@@ -20,12 +69,53 @@ namespace gl {
         [[nodiscard]] GLuint handle() const noexcept;
         void reset();
         bool add_shader(const std::string &source, GLenum type);
-        bool add_shader_binary(const std::string &binary, GLenum type);
+        // SPIR-V module specialized at entry_point. constants not listed keep the defaults of the module.
+        // false without OpenGL 4.6 or GL_ARB_gl_spirv.
+        bool add_shader_binary(const std::string &binary, GLenum type, const std::string& entry_point = "main",
+                               span<const specialization_constant> constants = {});
+        // outputs captured by transform feedback, takes effect on the next link()
+        bool transform_feedback_varyings(const std::vector<std::string>& varyings, GLenum buffer_mode = GL_INTERLEAVED_ATTRIBS);
         bool link();
+        void reflect();
         void use() const;
         void unuse() const;
+        [[nodiscard]] const std::vector<program_resource>& resources() const noexcept;
+        // by hash only, names whose hashes collide are reported by reflect()
+        [[nodiscard]] const program_resource* find_resource(GLenum program_interface, name_hash name) const noexcept;
+        // compares the names as well
+        [[nodiscard]] const program_resource* find_resource(GLenum program_interface, std::string_view name) const noexcept;
+        [[nodiscard]] GLint uniform_location(name_hash name) const noexcept;
+        [[nodiscard]] GLint uniform_location(std::string_view name) const noexcept;
+        [[nodiscard]] GLint attribute_location(name_hash name) const noexcept;
+        [[nodiscard]] GLint attribute_location(std::string_view name) const noexcept;
+        [[nodiscard]] const program_resource* uniform_block(name_hash name) const noexcept;
+        [[nodiscard]] const program_resource* uniform_block(std::string_view name) const noexcept;
+        [[nodiscard]] const program_resource* storage_block(name_hash name) const noexcept;
+        [[nodiscard]] const program_resource* storage_block(std::string_view name) const noexcept;
+        // requires use()
+        template <class T>
+        void uniform(GLint location, const T& value) const {
+            if(location >= 0) uniform_value(0, location, 1, &value);
+        }
+        template <class T>
+        void uniform(name_hash name, const T& value) const {
+            uniform(uniform_location(name), value);
+        }
+        template <class T>
+        void program_uniform(GLint location, const T& value) const {
+            if(location >= 0) uniform_value(m_handle, location, 1, &value);
+        }
+        template <class T>
+        void program_uniform(name_hash name, const T& value) const {
+            program_uniform(uniform_location(name), value);
+        }
+        template <class T>
+        void program_uniform(GLint location, const T* values, GLsizei count) const {
+            if(location >= 0) uniform_value(m_handle, location, count, values);
+        }
     private:
         GLuint m_handle;
+        std::vector<program_resource> m_resources;
     };
 }
 
@@ -0,0 +1,57 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_SHADER_BATCH_H
+#define GL_SHADER_BATCH_H
+
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "gl++/shader.h"
+
+namespace gl {
+    enum class program_status {
+        pending,
+        ready,
+        failed
+    };
+
+    // submits compile and link of many programs without querying their status,
+    // so the driver can build them concurrently. programs must outlive their completion.
+    class shader_batch {
+    public:
+        shader_batch();
+        shader_batch(const shader_batch&) = delete;
+        shader_batch(shader_batch&& obj) noexcept;
+        shader_batch& operator=(const shader_batch&) = delete;
+        shader_batch& operator=(shader_batch&& obj) noexcept;
+        ~shader_batch();
+        std::size_t add(shader_program& program, const std::vector<shader_source>& sources);
+        program_status status(std::size_t index);
+        bool poll();
+        void wait();
+        [[nodiscard]] const std::string& log(std::size_t index) const;
+        [[nodiscard]] std::size_t size() const noexcept;
+        [[nodiscard]] std::size_t pending() const noexcept;
+        [[nodiscard]] bool parallel() const noexcept;
+    private:
+        struct entry {
+            shader_program* program;
+            std::vector<GLuint> shaders;
+            program_status status;
+            std::string log;
+        };
+        void complete(entry& e);
+        // deletes the shaders of the entries still pending
+        void release() noexcept;
+    private:
+        std::vector<entry> m_entries;
+        std::size_t m_pending;
+        bool m_parallel;
+    };
+}
+
+#endif //GL_SHADER_BATCH_H
@@ -0,0 +1,57 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_SHADER_VARIANTS_H
+#define GL_SHADER_VARIANTS_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "gl++/shader.h"
+#include "gl++/span.h"
+
+namespace gl {
+    struct spirv_stage {
+        std::string binary;
+        GLenum type;
+        std::string entry_point = "main";
+    };
+
+    // SpecId decorations of a SPIR-V module, empty if binary is not one
+    std::vector<GLuint> specialization_ids(const std::string& binary);
+
+    // programs specialized from the same SPIR-V stages, linked on first use and kept per set of constants.
+    // each stage gets only the constants its module declares, so one set can cover every stage.
+    class shader_variants {
+    public:
+        explicit shader_variants(std::vector<spirv_stage> stages);
+        // nullptr if the variant fails to build, which is remembered as well
+        shader_program* get(span<const specialization_constant> constants);
+        shader_program* get(std::initializer_list<specialization_constant> constants);
+        [[nodiscard]] std::size_t size() const noexcept;
+        [[nodiscard]] std::size_t hits() const noexcept;
+        [[nodiscard]] std::size_t misses() const noexcept;
+        void reset_statistics() noexcept;
+        void clear();
+    private:
+        bool build(shader_program& program, const std::vector<specialization_constant>& constants) const;
+    private:
+        struct stage {
+            spirv_stage source;
+            std::vector<GLuint> ids;
+        };
+        std::vector<stage> m_stages;
+        // keyed by the constants sorted by id
+        std::map<std::vector<specialization_constant>, shader_program> m_variants;
+        std::size_t m_hits;
+        std::size_t m_misses;
+    };
+}
+
+#endif //GL_SHADER_VARIANTS_H
@@ -0,0 +1,80 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_SPAN_H
+#define GL_SPAN_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace gl {
+    template <class Container, class T, class=void>
+    struct is_span_compatible : std::false_type {};
+    template <class Container, class T>
+    struct is_span_compatible<Container, T, std::void_t<decltype(std::data(std::declval<Container&>())), decltype(std::size(std::declval<Container&>()))>> :
+            std::is_convertible<std::remove_pointer_t<decltype(std::data(std::declval<Container&>()))>(*)[], T(*)[]> {};
+
+    template <class T>
+    class span {
+    public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using pointer = T*;
+        using reference = T&;
+        using iterator = T*;
+    public:
+        constexpr span() noexcept : m_data(nullptr), m_size(0) {}
+        constexpr span(pointer data, std::size_t size) noexcept : m_data(data), m_size(size) {}
+        template <std::size_t N>
+        constexpr span(T (&array)[N]) noexcept : m_data(array), m_size(N) {}
+        template <class Container, class=std::enable_if_t<is_span_compatible<Container, T>::value>>
+        constexpr span(Container& container) : m_data(std::data(container)), m_size(std::size(container)) {}
+        template <class Container, class=std::enable_if_t<is_span_compatible<const Container, T>::value>>
+        constexpr span(const Container& container) : m_data(std::data(container)), m_size(std::size(container)) {}
+        template <class U, class=std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+        constexpr span(const span<U>& obj) noexcept : m_data(obj.data()), m_size(obj.size()) {}
+
+        [[nodiscard]] constexpr pointer data() const noexcept {
+            return m_data;
+        }
+        [[nodiscard]] constexpr std::size_t size() const noexcept {
+            return m_size;
+        }
+        [[nodiscard]] constexpr std::size_t size_bytes() const noexcept {
+            return m_size * sizeof(T);
+        }
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return m_size == 0;
+        }
+        [[nodiscard]] constexpr iterator begin() const noexcept {
+            return m_data;
+        }
+        [[nodiscard]] constexpr iterator end() const noexcept {
+            return m_data + m_size;
+        }
+        constexpr reference operator[](std::size_t index) const {
+            return m_data[index];
+        }
+        [[nodiscard]] constexpr span<T> subspan(std::size_t offset, std::size_t count) const {
+            if(offset >= m_size) return span<T>(m_data + m_size, 0);
+            return span<T>(m_data + offset, count > m_size - offset ? m_size - offset : count);
+        }
+    private:
+        pointer m_data;
+        std::size_t m_size;
+    };
+
+    template <class T>
+    span(T*, std::size_t) -> span<T>;
+    template <class T, std::size_t N>
+    span(T (&)[N]) -> span<T>;
+    template <class Container>
+    span(Container&) -> span<std::remove_pointer_t<decltype(std::data(std::declval<Container&>()))>>;
+    template <class Container>
+    span(const Container&) -> span<std::remove_pointer_t<decltype(std::data(std::declval<const Container&>()))>>;
+}
+
+#endif //GL_SPAN_H
@@ -0,0 +1,189 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_STATE_CACHE_H
+#define GL_STATE_CACHE_H
+
+#include <array>
+#include <cstddef>
+
+#include <GL/glew.h>
+
+#include "gl++/profiler.h"
+
+namespace gl {
+    // remembers the bindings made through gl++ on the current thread's context and skips redundant calls.
+    // call invalidate() after binding objects with raw GL calls or switching contexts.
+    class context_state {
+    public:
+        static constexpr GLuint unknown = ~0u;
+    public:
+        context_state() noexcept : m_buffers(), m_program(unknown), m_vertex_array(unknown), m_issued(0), m_elided(0) {
+            m_buffers.fill(unknown);
+        }
+        bool bind_buffer(GLenum target, GLuint handle) {
+            auto index = target_index(target);
+            if(index < m_buffers.size() && m_buffers[index] == handle) {
+                m_elided++;
+                return false;
+            }
+            glBindBuffer(target, handle);
+            if(index < m_buffers.size()) m_buffers[index] = handle;
+            m_issued++;
+            return true;
+        }
+        // indexed bindings are always issued, but they also change the generic binding of target
+        void bind_buffer_base(GLenum target, GLuint index, GLuint handle) {
+            glBindBufferBase(target, index, handle);
+            bound(target, handle);
+        }
+        void bind_buffer_range(GLenum target, GLuint index, GLuint handle, GLintptr offset, GLsizeiptr size) {
+            glBindBufferRange(target, index, handle, offset, size);
+            bound(target, handle);
+        }
+        bool use_program(GLuint handle) {
+            if(m_program == handle) {
+                m_elided++;
+                return false;
+            }
+            glUseProgram(handle);
+            profile_program_bind();
+            m_program = handle;
+            m_issued++;
+            return true;
+        }
+        bool bind_vertex_array(GLuint handle) {
+            if(m_vertex_array == handle) {
+                m_elided++;
+                return false;
+            }
+            glBindVertexArray(handle);
+            m_vertex_array = handle;
+            // the element array binding belongs to the vertex array
+            m_buffers[target_index(GL_ELEMENT_ARRAY_BUFFER)] = unknown;
+            m_issued++;
+            return true;
+        }
+        [[nodiscard]] GLuint buffer(GLenum target) const noexcept {
+            auto index = target_index(target);
+            return index < m_buffers.size() ? m_buffers[index] : unknown;
+        }
+        [[nodiscard]] GLuint program() const noexcept {
+            return m_program;
+        }
+        [[nodiscard]] GLuint vertex_array() const noexcept {
+            return m_vertex_array;
+        }
+        // the binding actually set in GL, queried once when it is unknown
+        GLuint query_vertex_array() {
+            if(m_vertex_array == unknown) {
+                GLint handle;
+                glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &handle);
+                m_vertex_array = handle;
+            }
+            return m_vertex_array;
+        }
+        GLuint query_buffer(GLenum target) {
+            auto index = target_index(target);
+            if(index >= m_buffers.size()) return unknown;
+            if(m_buffers[index] == unknown) {
+                GLint handle;
+                glGetIntegerv(binding_name(target), &handle);
+                m_buffers[index] = handle;
+            }
+            return m_buffers[index];
+        }
+        GLuint query_program() {
+            if(m_program == unknown) {
+                GLint handle;
+                glGetIntegerv(GL_CURRENT_PROGRAM, &handle);
+                m_program = handle;
+            }
+            return m_program;
+        }
+        // deleting a bound buffer or vertex array resets its bindings to 0
+        void forget_buffer(GLuint handle) noexcept {
+            for(auto& buffer : m_buffers) {
+                if(buffer == handle) buffer = 0;
+            }
+            // unbinding it from an indexed binding point can reset the generic binding of that target as well
+            for(auto target : { GL_TRANSFORM_FEEDBACK_BUFFER, GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER }) {
+                m_buffers[target_index(target)] = unknown;
+            }
+        }
+        void forget_vertex_array(GLuint handle) noexcept {
+            if(m_vertex_array == handle) {
+                m_vertex_array = 0;
+                m_buffers[target_index(GL_ELEMENT_ARRAY_BUFFER)] = unknown;
+            }
+        }
+        void invalidate() noexcept {
+            m_buffers.fill(unknown);
+            m_program = unknown;
+            m_vertex_array = unknown;
+        }
+        [[nodiscard]] std::size_t issued() const noexcept {
+            return m_issued;
+        }
+        [[nodiscard]] std::size_t elided() const noexcept {
+            return m_elided;
+        }
+        void reset_statistics() noexcept {
+            m_issued = 0;
+            m_elided = 0;
+        }
+    private:
+        void bound(GLenum target, GLuint handle) noexcept {
+            auto index = target_index(target);
+            if(index < m_buffers.size()) m_buffers[index] = handle;
+            m_issued++;
+        }
+        static constexpr std::size_t target_index(GLenum target) noexcept {
+            switch(target) {
+                case GL_ARRAY_BUFFER: return 0;
+                case GL_COPY_READ_BUFFER: return 1;
+                case GL_COPY_WRITE_BUFFER: return 2;
+                case GL_ELEMENT_ARRAY_BUFFER: return 3;
+                case GL_PIXEL_PACK_BUFFER: return 4;
+                case GL_PIXEL_UNPACK_BUFFER: return 5;
+                case GL_TRANSFORM_FEEDBACK_BUFFER: return 6;
+                case GL_UNIFORM_BUFFER: return 7;
+                case GL_DRAW_INDIRECT_BUFFER: return 8;
+                case GL_SHADER_STORAGE_BUFFER: return 9;
+                case GL_DISPATCH_INDIRECT_BUFFER: return 10;
+                default: return target_count;
+            }
+        }
+        static constexpr GLenum binding_name(GLenum target) noexcept {
+            switch(target) {
+                case GL_ARRAY_BUFFER: return GL_ARRAY_BUFFER_BINDING;
+                case GL_COPY_READ_BUFFER: return GL_COPY_READ_BUFFER_BINDING;
+                case GL_COPY_WRITE_BUFFER: return GL_COPY_WRITE_BUFFER_BINDING;
+                case GL_ELEMENT_ARRAY_BUFFER: return GL_ELEMENT_ARRAY_BUFFER_BINDING;
+                case GL_PIXEL_PACK_BUFFER: return GL_PIXEL_PACK_BUFFER_BINDING;
+                case GL_PIXEL_UNPACK_BUFFER: return GL_PIXEL_UNPACK_BUFFER_BINDING;
+                case GL_TRANSFORM_FEEDBACK_BUFFER: return GL_TRANSFORM_FEEDBACK_BUFFER_BINDING;
+                case GL_UNIFORM_BUFFER: return GL_UNIFORM_BUFFER_BINDING;
+                case GL_DRAW_INDIRECT_BUFFER: return GL_DRAW_INDIRECT_BUFFER_BINDING;
+                case GL_SHADER_STORAGE_BUFFER: return GL_SHADER_STORAGE_BUFFER_BINDING;
+                case GL_DISPATCH_INDIRECT_BUFFER: return GL_DISPATCH_INDIRECT_BUFFER_BINDING;
+                default: return 0;
+            }
+        }
+        static constexpr std::size_t target_count = 11;
+    private:
+        std::array<GLuint, target_count> m_buffers;
+        GLuint m_program;
+        GLuint m_vertex_array;
+        std::size_t m_issued;
+        std::size_t m_elided;
+    };
+
+    inline context_state& current_state() {
+        thread_local context_state state;
+        return state;
+    }
+}
+
+#endif //GL_STATE_CACHE_H
@@ -0,0 +1,170 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_STREAM_BUFFER_H
+#define GL_STREAM_BUFFER_H
+
+#include <array>
+#include <chrono>
+
+#include <GL/glew.h>
+
+#include "gl++/deletion_queue.h"
+#include "gl++/direct_state_access.h"
+#include "gl++/span.h"
+#include "gl++/state_cache.h"
+#include "gl++/vertex_buffer.h"
+
+namespace gl {
+    // persistently mapped buffer split into Regions slices which are written in turn.
+    // each slice is guarded by a fence, so map() only waits when the GPU is still reading the slice.
+    template <class Traits, std::size_t Regions = 3>
+    class stream_buffer {
+    public:
+        using value_type = typename Traits::value_type;
+        static constexpr GLenum buffer_target = Traits::target;
+        static constexpr std::size_t region_count = Regions;
+        static constexpr GLbitfield map_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        static_assert(Regions > 0);
+    public:
+        explicit stream_buffer(std::size_t size) : m_size(size), m_region(0), m_handle(0), m_data(nullptr), m_fences(), m_wait_time(0), m_wait_count(0) {
+            auto bytes = sizeof(value_type) * m_size * region_count;
+            if(direct_state_access()) {
+                glCreateBuffers(1, &m_handle);
+                if(bytes > 0) {
+                    glNamedBufferStorage(m_handle, bytes, nullptr, map_flags);
+                    m_data = static_cast<value_type*>(glMapNamedBufferRange(m_handle, 0, bytes, map_flags));
+                }
+            } else {
+                glGenBuffers(1, &m_handle);
+                current_state().bind_buffer(buffer_target, m_handle);
+                if(bytes > 0) {
+                    glBufferStorage(buffer_target, bytes, nullptr, map_flags);
+                    m_data = static_cast<value_type*>(glMapBufferRange(buffer_target, 0, bytes, map_flags));
+                }
+            }
+            // without a mapping there is nothing to write into, so the buffer is dropped
+            if(!m_data) {
+                release();
+                m_size = 0;
+            }
+        }
+        stream_buffer(const stream_buffer<Traits, Regions>&) = delete;
+        stream_buffer(stream_buffer<Traits, Regions>&& obj) noexcept :
+                m_size(obj.m_size), m_region(obj.m_region), m_handle(obj.m_handle), m_data(obj.m_data), m_fences(obj.m_fences),
+                m_wait_time(obj.m_wait_time), m_wait_count(obj.m_wait_count) {
+            obj.m_handle = 0;
+            obj.m_data = nullptr;
+            obj.m_fences.fill(nullptr);
+        }
+        stream_buffer<Traits, Regions>& operator=(const stream_buffer<Traits, Regions>&) = delete;
+        stream_buffer<Traits, Regions>& operator=(stream_buffer<Traits, Regions>&& obj) noexcept {
+            if(this != &obj) {
+                release();
+                m_size = obj.m_size;
+                m_region = obj.m_region;
+                m_handle = obj.m_handle;
+                m_data = obj.m_data;
+                m_fences = obj.m_fences;
+                m_wait_time = obj.m_wait_time;
+                m_wait_count = obj.m_wait_count;
+                obj.m_handle = 0;
+                obj.m_data = nullptr;
+                obj.m_fences.fill(nullptr);
+            }
+            return *this;
+        }
+        ~stream_buffer() {
+            release();
+        }
+        void vertex_pointer(GLuint location, GLboolean normalized, this_select_t this_, GLuint divisor = 0) {
+            vertex_attrib_pointer<value_type>(location, normalized, 0, 0, divisor);
+        }
+        template <class T>
+        void vertex_pointer(GLuint location, GLboolean normalized, T value_t<value_type>::*member, GLuint divisor = 0) {
+            vertex_attrib_pointer<T>(location, normalized, sizeof(value_type), member_offset(member), divisor);
+        }
+        // false if the storage could not be created or mapped, e.g. for a size of 0
+        [[nodiscard]] bool valid() const noexcept {
+            return m_data != nullptr;
+        }
+        [[nodiscard]] GLuint handle() const noexcept {
+            return m_handle;
+        }
+        void bind() {
+            current_state().bind_buffer(buffer_target, m_handle);
+        }
+        void unbind() {
+            current_state().bind_buffer(buffer_target, 0);
+        }
+        // waits until the GPU has released the current region and returns it for writing.
+        // the returned span stays valid until the next call of fence().
+        [[nodiscard]] span<value_type> map() {
+            if(!valid()) return span<value_type>();
+            if(GLsync& sync = m_fences[m_region]) {
+                if(glClientWaitSync(sync, 0, 0) == GL_TIMEOUT_EXPIRED) {
+                    auto start = std::chrono::steady_clock::now();
+                    while(glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+                    m_wait_time += std::chrono::steady_clock::now() - start;
+                    m_wait_count++;
+                }
+                glDeleteSync(sync);
+                sync = nullptr;
+            }
+            return span<value_type>(m_data + offset(), m_size);
+        }
+        // marks the commands issued so far as the last readers of the current region and moves to the next one.
+        void fence() {
+            if(!valid()) return;
+            if(m_fences[m_region]) glDeleteSync(m_fences[m_region]);
+            m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            m_region = (m_region + 1) % region_count;
+        }
+        [[nodiscard]] std::size_t offset() const noexcept {
+            return m_region * m_size;
+        }
+        [[nodiscard]] std::size_t region() const noexcept {
+            return m_region;
+        }
+        [[nodiscard]] std::size_t size() const noexcept {
+            return m_size;
+        }
+        [[nodiscard]] std::size_t capacity() const noexcept {
+            return m_size * region_count;
+        }
+        [[nodiscard]] std::chrono::nanoseconds wait_time() const noexcept {
+            return m_wait_time;
+        }
+        [[nodiscard]] std::size_t wait_count() const noexcept {
+            return m_wait_count;
+        }
+        void reset_counters() noexcept {
+            m_wait_time = std::chrono::nanoseconds(0);
+            m_wait_count = 0;
+        }
+    private:
+        void release() {
+            for(auto& sync : m_fences) {
+                if(sync) glDeleteSync(sync);
+                sync = nullptr;
+            }
+            if(m_handle) {
+                // immutable storage cannot be respecified, so it is never recycled
+                delete_buffer(m_handle, 0, 0);
+                m_handle = 0;
+                m_data = nullptr;
+            }
+        }
+    private:
+        std::size_t m_size;
+        std::size_t m_region;
+        GLuint m_handle;
+        value_type* m_data;
+        std::array<GLsync, Regions> m_fences;
+        std::chrono::nanoseconds m_wait_time;
+        std::size_t m_wait_count;
+    };
+}
+
+#endif //GL_STREAM_BUFFER_H
@@ -0,0 +1,62 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_TRANSFORM_FEEDBACK_H
+#define GL_TRANSFORM_FEEDBACK_H
+
+#include <cstddef>
+
+#include <GL/glew.h>
+
+#include "gl++/vertex_buffer.h"
+
+namespace gl {
+    // transform feedback object with its capture buffers and a query counting the primitives of the last pass.
+    // the program has to declare its varyings with shader_program::transform_feedback_varyings() before link().
+    class transform_feedback {
+    public:
+        transform_feedback();
+        transform_feedback(const transform_feedback&) = delete;
+        transform_feedback(transform_feedback&& obj) noexcept;
+        transform_feedback& operator=(const transform_feedback&) = delete;
+        transform_feedback& operator=(transform_feedback&& obj) noexcept;
+        ~transform_feedback();
+        [[nodiscard]] GLuint handle() const noexcept;
+        // the captured varyings of buffer index go to buffer, the whole buffer when size is 0
+        void capture(GLuint index, GLuint buffer, GLintptr offset = 0, GLsizeiptr size = 0);
+        template <class Traits>
+        void capture(GLuint index, const vertex_buffer<Traits>& buffer, std::size_t offset = 0, std::size_t size = 0) {
+            using value_type = typename Traits::value_type;
+            capture(index, buffer.handle(), offset * sizeof(value_type), size * sizeof(value_type));
+        }
+        // primitive_mode is GL_POINTS, GL_LINES or GL_TRIANGLES, matching the draws of the pass.
+        // with discard, the pass skips rasterization and only writes the capture buffers.
+        void begin(GLenum primitive_mode, bool discard = true);
+        void end();
+        template <class Draw>
+        void run(GLenum primitive_mode, Draw&& draw, bool discard = true) {
+            begin(primitive_mode, discard);
+            draw();
+            end();
+        }
+        void pause();
+        void resume();
+        // draws the vertices captured by the last pass. the count never leaves the GPU.
+        void draw(GLenum mode, GLsizei instance_count = 1) const;
+        // false while the primitive count of the last pass is still in flight
+        [[nodiscard]] bool result_available() const;
+        // waits for the primitive count of the last pass
+        [[nodiscard]] GLuint primitives_written() const;
+        // false without waiting if the count is not available yet
+        bool primitives_written(GLuint& count) const;
+        // the GPU writes the count as a GLuint at offset bytes into buffer when the pass completes
+        void primitives_written(GLuint buffer, GLintptr offset) const;
+    private:
+        GLuint m_handle;
+        GLuint m_query;
+        bool m_discard;
+    };
+}
+
+#endif //GL_TRANSFORM_FEEDBACK_H
@@ -0,0 +1,125 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_UNIFORM_H
+#define GL_UNIFORM_H
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+namespace gl {
+    // FNV-1a hash of a resource name. a trailing "[0]" is ignored like glGetUniformLocation does.
+    class name_hash {
+    public:
+        constexpr explicit name_hash(std::string_view name) noexcept : m_value(hash(strip(name))) {}
+        [[nodiscard]] constexpr std::uint32_t value() const noexcept {
+            return m_value;
+        }
+        constexpr bool operator==(const name_hash& obj) const noexcept {
+            return m_value == obj.m_value;
+        }
+        constexpr bool operator!=(const name_hash& obj) const noexcept {
+            return m_value != obj.m_value;
+        }
+    private:
+        static constexpr std::string_view strip(std::string_view name) noexcept {
+            if(name.size() > 3 && name.substr(name.size() - 3) == "[0]") return name.substr(0, name.size() - 3);
+            return name;
+        }
+        static constexpr std::uint32_t hash(std::string_view name) noexcept {
+            std::uint32_t value = 2166136261u;
+            for(char c : name) {
+                value ^= static_cast<unsigned char>(c);
+                value *= 16777619u;
+            }
+            return value;
+        }
+    private:
+        std::uint32_t m_value;
+    };
+
+    namespace literals {
+        constexpr name_hash operator""_name(const char* name, std::size_t size) noexcept {
+            return name_hash(std::string_view(name, size));
+        }
+    }
+
+    template <class T>
+    struct uniform_traits {
+        using type = T;
+        static constexpr glm::length_t columns = 1;
+        static constexpr glm::length_t rows = 1;
+    };
+    template <glm::length_t L, class T, glm::qualifier Q>
+    struct uniform_traits<glm::vec<L, T, Q>> {
+        using type = T;
+        static constexpr glm::length_t columns = 1;
+        static constexpr glm::length_t rows = L;
+    };
+    template <glm::length_t C, glm::length_t R, class T, glm::qualifier Q>
+    struct uniform_traits<glm::mat<C, R, T, Q>> {
+        using type = T;
+        static constexpr glm::length_t columns = C;
+        static constexpr glm::length_t rows = R;
+    };
+
+    // program == 0 updates the program in use with glUniform*, otherwise glProgramUniform* is used.
+    template <class T>
+    void uniform_value(GLuint program, GLint location, GLsizei count, const T* value) {
+        using traits = uniform_traits<T>;
+        using type = std::remove_cv_t<typename traits::type>;
+        auto data = reinterpret_cast<const type*>(value);
+        constexpr auto C = traits::columns;
+        constexpr auto R = traits::rows;
+        if constexpr(C == 1 && std::is_same_v<type, GLfloat>) {
+            if constexpr(R == 1) program ? glProgramUniform1fv(program, location, count, data) : glUniform1fv(location, count, data);
+            else if constexpr(R == 2) program ? glProgramUniform2fv(program, location, count, data) : glUniform2fv(location, count, data);
+            else if constexpr(R == 3) program ? glProgramUniform3fv(program, location, count, data) : glUniform3fv(location, count, data);
+            else if constexpr(R == 4) program ? glProgramUniform4fv(program, location, count, data) : glUniform4fv(location, count, data);
+        } else if constexpr(C == 1 && std::is_same_v<type, GLint>) {
+            if constexpr(R == 1) program ? glProgramUniform1iv(program, location, count, data) : glUniform1iv(location, count, data);
+            else if constexpr(R == 2) program ? glProgramUniform2iv(program, location, count, data) : glUniform2iv(location, count, data);
+            else if constexpr(R == 3) program ? glProgramUniform3iv(program, location, count, data) : glUniform3iv(location, count, data);
+            else if constexpr(R == 4) program ? glProgramUniform4iv(program, location, count, data) : glUniform4iv(location, count, data);
+        } else if constexpr(C == 1 && std::is_same_v<type, GLuint>) {
+            if constexpr(R == 1) program ? glProgramUniform1uiv(program, location, count, data) : glUniform1uiv(location, count, data);
+            else if constexpr(R == 2) program ? glProgramUniform2uiv(program, location, count, data) : glUniform2uiv(location, count, data);
+            else if constexpr(R == 3) program ? glProgramUniform3uiv(program, location, count, data) : glUniform3uiv(location, count, data);
+            else if constexpr(R == 4) program ? glProgramUniform4uiv(program, location, count, data) : glUniform4uiv(location, count, data);
+        } else if constexpr(C == 1 && std::is_same_v<type, GLdouble>) {
+            if constexpr(R == 1) program ? glProgramUniform1dv(program, location, count, data) : glUniform1dv(location, count, data);
+            else if constexpr(R == 2) program ? glProgramUniform2dv(program, location, count, data) : glUniform2dv(location, count, data);
+            else if constexpr(R == 3) program ? glProgramUniform3dv(program, location, count, data) : glUniform3dv(location, count, data);
+            else if constexpr(R == 4) program ? glProgramUniform4dv(program, location, count, data) : glUniform4dv(location, count, data);
+        } else if constexpr(std::is_same_v<type, GLfloat>) {
+            if constexpr(C == 2 && R == 2) program ? glProgramUniformMatrix2fv(program, location, count, GL_FALSE, data) : glUniformMatrix2fv(location, count, GL_FALSE, data);
+            else if constexpr(C == 2 && R == 3) program ? glProgramUniformMatrix2x3fv(program, location, count, GL_FALSE, data) : glUniformMatrix2x3fv(location, count, GL_FALSE, data);
+            else if constexpr(C == 2 && R == 4) program ? glProgramUniformMatrix2x4fv(program, location, count, GL_FALSE, data) : glUniformMatrix2x4fv(location, count, GL_FALSE, data);
+            else if constexpr(C == 3 && R == 2) program ? glProgramUniformMatrix3x2fv(program, location, count, GL_FALSE, data) : glUniformMatrix3x2fv(location, count, GL_FALSE, data);
+            else if constexpr(C == 3 && R == 3) program ? glProgramUniformMatrix3fv(program, location, count, GL_FALSE, data) : glUniformMatrix3fv(location, count, GL_FALSE, data);
+            else if constexpr(C == 3 && R == 4) program ? glProgramUniformMatrix3x4fv(program, location, count, GL_FALSE, data) : glUniformMatrix3x4fv(location, count, GL_FALSE, data);
+            else if constexpr(C == 4 && R == 2) program ? glProgramUniformMatrix4x2fv(program, location, count, GL_FALSE, data) : glUniformMatrix4x2fv(location, count, GL_FALSE, data);
+            else if constexpr(C == 4 && R == 3) program ? glProgramUniformMatrix4x3fv(program, location, count, GL_FALSE, data) : glUniformMatrix4x3fv(location, count, GL_FALSE, data);
+            else if constexpr(C == 4 && R == 4) program ? glProgramUniformMatrix4fv(program, location, count, GL_FALSE, data) : glUniformMatrix4fv(location, count, GL_FALSE, data);
+        } else if constexpr(std::is_same_v<type, GLdouble>) {
+            if constexpr(C == 2 && R == 2) program ? glProgramUniformMatrix2dv(program, location, count, GL_FALSE, data) : glUniformMatrix2dv(location, count, GL_FALSE, data);
+            else if constexpr(C == 2 && R == 3) program ? glProgramUniformMatrix2x3dv(program, location, count, GL_FALSE, data) : glUniformMatrix2x3dv(location, count, GL_FALSE, data);
+            else if constexpr(C == 2 && R == 4) program ? glProgramUniformMatrix2x4dv(program, location, count, GL_FALSE, data) : glUniformMatrix2x4dv(location, count, GL_FALSE, data);
+            else if constexpr(C == 3 && R == 2) program ? glProgramUniformMatrix3x2dv(program, location, count, GL_FALSE, data) : glUniformMatrix3x2dv(location, count, GL_FALSE, data);
+            else if constexpr(C == 3 && R == 3) program ? glProgramUniformMatrix3dv(program, location, count, GL_FALSE, data) : glUniformMatrix3dv(location, count, GL_FALSE, data);
+            else if constexpr(C == 3 && R == 4) program ? glProgramUniformMatrix3x4dv(program, location, count, GL_FALSE, data) : glUniformMatrix3x4dv(location, count, GL_FALSE, data);
+            else if constexpr(C == 4 && R == 2) program ? glProgramUniformMatrix4x2dv(program, location, count, GL_FALSE, data) : glUniformMatrix4x2dv(location, count, GL_FALSE, data);
+            else if constexpr(C == 4 && R == 3) program ? glProgramUniformMatrix4x3dv(program, location, count, GL_FALSE, data) : glUniformMatrix4x3dv(location, count, GL_FALSE, data);
+            else if constexpr(C == 4 && R == 4) program ? glProgramUniformMatrix4dv(program, location, count, GL_FALSE, data) : glUniformMatrix4dv(location, count, GL_FALSE, data);
+        } else {
+            static_assert(std::is_same_v<type, GLfloat>, "unsupported uniform type");
+        }
+    }
+}
+
+#endif //GL_UNIFORM_H
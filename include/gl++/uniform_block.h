@@ -0,0 +1,176 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_UNIFORM_BLOCK_H
+#define GL_UNIFORM_BLOCK_H
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <optional>
+#include <type_traits>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "gl++/shader.h"
+#include "gl++/span.h"
+#include "gl++/stream_buffer.h"
+#include "gl++/uniform.h"
+#include "gl++/vertex_buffer.h"
+
+namespace gl {
+    enum class block_packing {
+        std140,
+        std430
+    };
+
+    template <block_packing Packing, class... Members>
+    struct block_struct;
+
+    // base alignment and size of a block member under the packing rules of GLSL 4.30 section 7.6.2.2
+    template <block_packing Packing, class T, class = void>
+    struct block_member;
+    template <block_packing Packing, class T>
+    struct block_member<Packing, T, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>> {
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8, "block scalars are 32 or 64 bit");
+        static constexpr std::size_t alignment = sizeof(T);
+        static constexpr std::size_t size = sizeof(T);
+    };
+    template <block_packing Packing, glm::length_t L, class T, glm::qualifier Q>
+    struct block_member<Packing, glm::vec<L, T, Q>> {
+        // a vec3 is aligned like a vec4 but only takes three components, so a scalar may follow it
+        static constexpr std::size_t alignment = (L == 2 ? 2 : 4) * block_member<Packing, T>::size;
+        static constexpr std::size_t size = L * block_member<Packing, T>::size;
+    };
+    // arrays round their element stride up to the element alignment, std140 also rounds both up to a vec4
+    template <block_packing Packing, class T, std::size_t N>
+    struct block_member<Packing, T[N]> {
+        static constexpr std::size_t element_alignment = Packing == block_packing::std140 && block_member<Packing, T>::alignment < 16 ?
+                16 : block_member<Packing, T>::alignment;
+        static constexpr std::size_t stride = (block_member<Packing, T>::size + element_alignment - 1) / element_alignment * element_alignment;
+        static constexpr std::size_t alignment = element_alignment;
+        static constexpr std::size_t size = stride * N;
+    };
+    template <block_packing Packing, class T, std::size_t N>
+    struct block_member<Packing, std::array<T, N>> : block_member<Packing, T[N]> {};
+    // column major matrices are arrays of their columns
+    template <block_packing Packing, glm::length_t C, glm::length_t R, class T, glm::qualifier Q>
+    struct block_member<Packing, glm::mat<C, R, T, Q>> : block_member<Packing, glm::vec<R, T, Q>[C]> {};
+    template <block_packing Packing, class... Members>
+    struct block_member<Packing, block_struct<Packing, Members...>> {
+        static constexpr std::size_t alignment = block_struct<Packing, Members...>::alignment;
+        static constexpr std::size_t size = block_struct<Packing, Members...>::size;
+    };
+
+    // layout of a block, or of a struct inside one, with the given member types in declaration order.
+    // the C++ struct mirroring the block is checked against it with static_assert(offsetof(...) == offset<I>).
+    template <block_packing Packing, class... Members>
+    struct block_struct {
+        static constexpr block_packing packing = Packing;
+        static constexpr std::size_t member_count = sizeof...(Members);
+    private:
+        static constexpr std::size_t round_up(std::size_t value, std::size_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+        static constexpr std::size_t max_alignment() {
+            std::size_t value = Packing == block_packing::std140 ? 16 : 1;
+            ((value = block_member<Packing, Members>::alignment > value ? block_member<Packing, Members>::alignment : value), ...);
+            return value;
+        }
+        static constexpr std::array<std::size_t, sizeof...(Members) + 1> layout() {
+            std::array<std::size_t, sizeof...(Members) + 1> result {};
+            constexpr std::size_t alignments[] = { block_member<Packing, Members>::alignment..., 1 };
+            constexpr std::size_t sizes[] = { block_member<Packing, Members>::size..., 0 };
+            std::size_t end = 0;
+            for(std::size_t i = 0; i < sizeof...(Members); i++) {
+                result[i] = round_up(end, alignments[i]);
+                end = result[i] + sizes[i];
+            }
+            result[sizeof...(Members)] = end;
+            return result;
+        }
+        static constexpr auto m_layout = layout();
+    public:
+        // std140 structs are aligned like a vec4
+        static constexpr std::size_t alignment = max_alignment();
+        // including the padding up to the next element of an array of this struct
+        static constexpr std::size_t size = round_up(m_layout[sizeof...(Members)], alignment);
+        static constexpr std::array<std::size_t, sizeof...(Members)> offsets = [] {
+            std::array<std::size_t, sizeof...(Members)> result {};
+            for(std::size_t i = 0; i < sizeof...(Members); i++) result[i] = m_layout[i];
+            return result;
+        }();
+        template <std::size_t I>
+        static constexpr std::size_t offset = m_layout[I];
+    };
+    template <class... Members>
+    using std140_block = block_struct<block_packing::std140, Members...>;
+    template <class... Members>
+    using std430_block = block_struct<block_packing::std430, Members...>;
+
+    // compares the offsets reflected from program with the expected ones. members are the reflected names in
+    // declaration order, e.g. "Camera.view" for a block with an instance name. false if any is missing or moved.
+    bool match_block_layout(const shader_program& program, GLenum block_interface, name_hash block,
+                            span<const name_hash> members, span<const std::size_t> offsets);
+    template <class Block>
+    bool match_block_layout(const shader_program& program, name_hash block, span<const name_hash> members) {
+        // std140 is what uniform blocks use by default, std430 is only allowed for storage blocks
+        auto block_interface = Block::packing == block_packing::std140 && program.uniform_block(block) ? GL_UNIFORM_BLOCK : GL_SHADER_STORAGE_BLOCK;
+        return members.size() == Block::member_count &&
+               match_block_layout(program, block_interface, block, members, span<const std::size_t>(Block::offsets.data(), Block::offsets.size()));
+    }
+    template <class Block>
+    bool match_block_layout(const shader_program& program, name_hash block, std::initializer_list<name_hash> members) {
+        return match_block_layout<Block>(program, block, span<const name_hash>(members.begin(), members.size()));
+    }
+
+    struct uniform_range {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+    };
+
+    // packs the uniform blocks of many draws into one persistently mapped buffer per frame. every block starts
+    // at a multiple of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, so it can be bound on its own with glBindBufferRange.
+    // frames are fenced like stream_buffer regions.
+    class uniform_allocator {
+    public:
+        using buffer_type = stream_buffer<buffer_trait<std::byte, GL_UNIFORM_BUFFER, GL_STREAM_DRAW>>;
+        explicit uniform_allocator(std::size_t frame_size);
+        // waits for the GPU to release the next frame and starts writing it
+        void begin_frame();
+        // fences the draws of the frame
+        void end_frame();
+        // nullopt when the frame has no room left
+        std::optional<uniform_range> push(const void* data, std::size_t size);
+        template <class T>
+        std::optional<uniform_range> push(const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            return push(&value, sizeof(T));
+        }
+        static void bind(GLuint point, const uniform_range& range);
+        // pushes and binds in one go, false when the frame has no room left
+        template <class T>
+        bool bind(GLuint point, const T& value) {
+            auto range = push(value);
+            if(range) bind(point, *range);
+            return range.has_value();
+        }
+        [[nodiscard]] std::size_t alignment() const noexcept;
+        [[nodiscard]] std::size_t frame_size() const noexcept;
+        // bytes of the current frame taken so far, padding included
+        [[nodiscard]] std::size_t used() const noexcept;
+        [[nodiscard]] const buffer_type& buffer() const noexcept;
+    private:
+        static std::size_t query_alignment();
+    private:
+        std::size_t m_alignment;
+        buffer_type m_buffer;
+        span<std::byte> m_frame;
+        std::size_t m_used;
+    };
+}
+
+#endif //GL_UNIFORM_BLOCK_H
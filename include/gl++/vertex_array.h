@@ -6,9 +6,13 @@
 #define GL_VERTEX_ARRAY_H
 
 #include <functional>
+#include <type_traits>
 
 #include <GL/glew.h>
 
+#include "gl++/direct_state_access.h"
+#include "gl++/primitive_type.h"
+
 namespace gl {
     class vertex_array {
     public:
@@ -19,6 +23,7 @@ namespace gl {
             operator bool() const;
         private:
             std::reference_wrapper<const vertex_array> array;
+            GLuint previous;
         };
     public:
         vertex_array();
@@ -28,6 +33,49 @@ namespace gl {
         [[nodiscard]] bind_context get_bind() const;
         void bind() const;
         void unbind() const;
+        void bind_vertex_buffer(GLuint binding, GLuint buffer, GLintptr offset, GLsizei stride) const;
+        void attrib_binding(GLuint location, GLuint binding) const;
+        void enable_attrib(GLuint location) const;
+        void binding_divisor(GLuint binding, GLuint divisor) const;
+        template <class T>
+        void attrib_format(GLuint location, GLboolean normalized, GLuint relative_offset) const {
+            auto size = attribute_components<T>;
+            auto type_value = gl_primitive_type<T>::value;
+            using type = std::remove_cv_t<typename gl_primitive_type<T>::type>;
+            normalized = normalized || is_normalized_attribute_v<type>;
+            if(!direct_state_access()) bind();
+            // the columns of a matrix are consecutive attributes
+            for(GLuint column = 0; column < attribute_columns<T>; column++) {
+                auto column_location = location + column * attribute_column_locations<T>;
+                auto column_offset = static_cast<GLuint>(relative_offset + column * (sizeof(T) / attribute_columns<T>));
+                if(direct_state_access()) {
+                    if constexpr(std::is_integral_v<type>) {
+                        glVertexArrayAttribIFormat(m_handle, column_location, size, type_value, column_offset);
+                    } else if constexpr(is_float_attribute_v<type>) {
+                        glVertexArrayAttribFormat(m_handle, column_location, size, type_value, normalized, column_offset);
+                    } else if constexpr(std::is_same_v<type, GLdouble>) {
+                        glVertexArrayAttribLFormat(m_handle, column_location, size, type_value, column_offset);
+                    }
+                } else {
+                    if constexpr(std::is_integral_v<type>) {
+                        glVertexAttribIFormat(column_location, size, type_value, column_offset);
+                    } else if constexpr(is_float_attribute_v<type>) {
+                        glVertexAttribFormat(column_location, size, type_value, normalized, column_offset);
+                    } else if constexpr(std::is_same_v<type, GLdouble>) {
+                        glVertexAttribLFormat(column_location, size, type_value, column_offset);
+                    }
+                }
+            }
+        }
+        // format, binding and enable of every location T takes
+        template <class T>
+        void attribute(GLuint location, GLboolean normalized, GLuint relative_offset, GLuint binding) const {
+            attrib_format<T>(location, normalized, relative_offset);
+            for(GLuint i = 0; i < attribute_locations<T>; i++) {
+                attrib_binding(location + i, binding);
+                enable_attrib(location + i);
+            }
+        }
     private:
         GLuint m_handle;
     };
@@ -5,13 +5,21 @@
 #ifndef GL_VERTEX_BUFFER_H
 #define GL_VERTEX_BUFFER_H
 
+#include <algorithm>
 #include <iterator>
 #include <type_traits>
 #include <vector>
 
 #include <GL/glew.h>
 
+#include "gl++/deletion_queue.h"
+#include "gl++/direct_state_access.h"
+#include "gl++/memory_barrier.h"
 #include "gl++/primitive_type.h"
+#include "gl++/profiler.h"
+#include "gl++/span.h"
+#include "gl++/state_cache.h"
+#include "gl++/vertex_array.h"
 
 namespace gl {
     template <GLenum V>
@@ -25,7 +33,8 @@ namespace gl {
             V == GL_TRANSFORM_FEEDBACK_BUFFER ||
             V == GL_UNIFORM_BUFFER ||
             V == GL_DRAW_INDIRECT_BUFFER ||
-            V == GL_SHADER_STORAGE_BUFFER;
+            V == GL_SHADER_STORAGE_BUFFER ||
+            V == GL_DISPATCH_INDIRECT_BUFFER;
 
     template <GLenum V>
     inline constexpr bool is_buffer_usage =
@@ -50,6 +59,15 @@ namespace gl {
         static constexpr GLenum usage = BufferUsage;
     };
 
+    // the smallest power of two that fits required, whatever the current capacity
+    struct power_of_two_growth {
+        std::size_t operator()(std::size_t, std::size_t required) const noexcept {
+            std::size_t size = 1;
+            while(size < required) size <<= 1;
+            return size;
+        }
+    };
+
     class this_select_t {};
     static inline constexpr this_select_t this_select;
 
@@ -57,6 +75,35 @@ namespace gl {
     template <class T>
     using value_t = std::conditional_t<std::is_class_v<T>, T, class_t>;
 
+    template <class Class, class T>
+    std::size_t member_offset(T Class::*member) {
+        return reinterpret_cast<std::size_t>(&reinterpret_cast<char const volatile&>(((Class*)nullptr)->*member));
+    }
+
+    // a divisor other than 0 advances the attribute once per that many instances instead of once per vertex
+    template <class T>
+    void vertex_attrib_pointer(GLuint location, GLboolean normalized, GLsizei stride, std::size_t offset, GLuint divisor = 0) {
+        auto size = attribute_components<T>;
+        auto type_value = gl_primitive_type<T>::value;
+        using type = std::remove_cv_t<typename gl_primitive_type<T>::type>;
+        // the columns of a matrix are consecutive attributes
+        if(stride == 0 && attribute_columns<T> > 1) stride = sizeof(T);
+        for(GLuint column = 0; column < attribute_columns<T>; column++) {
+            auto column_location = location + column * attribute_column_locations<T>;
+            auto column_offset = reinterpret_cast<void*>(offset + column * (sizeof(T) / attribute_columns<T>));
+            glEnableVertexAttribArray(column_location);
+            if constexpr(std::is_integral_v<type>) {
+                glVertexAttribIPointer(column_location, size, type_value, stride, column_offset);
+            } else if constexpr(is_float_attribute_v<type>) {
+                normalized = normalized || is_normalized_attribute_v<type>;
+                glVertexAttribPointer(column_location, size, type_value, normalized, stride, column_offset);
+            } else if constexpr(std::is_same_v<type, GLdouble>) {
+                glVertexAttribLPointer(column_location, size, type_value, stride, column_offset);
+            }
+            glVertexAttribDivisor(column_location, divisor);
+        }
+    }
+
     template <class Traits>
     class vertex_buffer {
     public:
@@ -78,11 +125,20 @@ namespace gl {
         vertex_buffer(const Iterator& begin, const Iterator& end): m_size(std::distance(begin, end)), m_handle(0)
         {
             m_capacity = m_size;
-            std::vector<value_type> data(begin, end);
-            glGenBuffers(1, &m_handle);
-            glBindBuffer(buffer_target, m_handle);
-            glBufferData(buffer_target, sizeof(value_type) * data.size(), data.data(), buffer_usage);
+            if constexpr(std::is_same_v<Iterator, value_type*> || std::is_same_v<Iterator, const value_type*>) {
+                allocate(begin);
+            } else {
+                std::vector<value_type> data(begin, end);
+                allocate(data.data());
+            }
         }
+        explicit vertex_buffer(std::size_t size) : m_size(size), m_capacity(size), m_handle(0) {
+            allocate(nullptr);
+        }
+        vertex_buffer(const value_type* data, std::size_t size) : m_size(size), m_capacity(size), m_handle(0) {
+            allocate(data);
+        }
+        explicit vertex_buffer(span<const value_type> data) : vertex_buffer(data.data(), data.size()) {}
         vertex_buffer(const vertex_buffer<Traits>&) = delete;
         vertex_buffer(vertex_buffer<Traits>&& obj)  noexcept : m_size(obj.m_size), m_capacity(obj.m_capacity), m_handle(obj.m_handle) {
             obj.m_handle = 0;
@@ -90,102 +146,127 @@ namespace gl {
         vertex_buffer<Traits>& operator=(const vertex_buffer<Traits>&) = delete;
         vertex_buffer<Traits>& operator=(vertex_buffer<Traits>&& obj) noexcept {
             if(this != &obj) {
+                delete_buffer(m_handle, m_capacity * sizeof(value_type), buffer_usage);
                 m_size = obj.m_size;
                 m_capacity = obj.m_capacity;
-                glDeleteBuffers(1, &m_handle);
                 m_handle = obj.m_handle;
                 obj.m_handle = 0;
             }
+            return *this;
         }
         ~vertex_buffer() {
-            if(m_handle) {
-                glDeleteBuffers(1, &m_handle);
-                m_handle = 0;
-            }
+            delete_buffer(m_handle, m_capacity * sizeof(value_type), buffer_usage);
+            m_handle = 0;
         }
-        void vertex_pointer(GLuint location, GLboolean normalized, this_select_t this_) {
-            glEnableVertexAttribArray(location);
-            auto size = sizeof(value_type) / sizeof(typename gl_primitive_type<value_type>::type);
-            auto type_value = gl_primitive_type<value_type>::value;
-            using type = std::remove_cv_t<typename gl_primitive_type<value_type>::type>;
-            if constexpr(std::is_integral_v<type>) {
-                glVertexAttribIPointer(location, size, type_value, 0, 0);
-            } else if constexpr(std::is_same_v<type, GLfloat>) {
-                glVertexAttribPointer(location, size, type_value, normalized, 0, 0);
-            } else if constexpr(std::is_same_v<type, GLdouble>) {
-                glVertexAttribLPointer(location, size, type_value, 0, 0);
+        void vertex_pointer(GLuint location, GLboolean normalized, this_select_t this_, GLuint divisor = 0) {
+            vertex_attrib_pointer<value_type>(location, normalized, 0, 0, divisor);
+        }
+        template <class T>
+        void vertex_pointer(GLuint location, GLboolean normalized, T value_t<value_type>::*member, GLuint divisor = 0) {
+            vertex_attrib_pointer<T>(location, normalized, sizeof(value_type), member_offset(member), divisor);
+        }
+        void vertex_pointer(const vertex_array& vao, GLuint location, GLboolean normalized, this_select_t this_, GLuint divisor = 0) {
+            if(direct_state_access()) {
+                vao.attribute<value_type>(location, normalized, 0, location);
+                vao.bind_vertex_buffer(location, m_handle, 0, sizeof(value_type));
+                vao.binding_divisor(location, divisor);
+            } else {
+                vao.bind();
+                bind();
+                vertex_pointer(location, normalized, this_, divisor);
             }
         }
         template <class T>
-        void vertex_pointer(GLuint location, GLboolean normalized, T value_t<value_type>::*member) {
-            glEnableVertexAttribArray(location);
-            auto start = reinterpret_cast<std::size_t>(&reinterpret_cast<char const volatile&>(((value_type*)nullptr)->*member));
-            auto size = sizeof(T) / sizeof(typename gl_primitive_type<T>::type);
-            auto type_value = gl_primitive_type<T>::value;
-            using type = std::remove_cv_t<typename gl_primitive_type<T>::type>;
-            if constexpr(std::is_integral_v<type>) {
-                glVertexAttribIPointer(location, size, type_value, sizeof(value_type), reinterpret_cast<void*>(start));
-            } else if constexpr(std::is_same_v<type, GLfloat>) {
-                glVertexAttribPointer(location, size, type_value, normalized, sizeof(value_type), reinterpret_cast<void*>(start));
-            } else if constexpr(std::is_same_v<type, GLdouble>) {
-                glVertexAttribLPointer(location, size, type_value, sizeof(value_type), reinterpret_cast<void*>(start));
+        void vertex_pointer(const vertex_array& vao, GLuint location, GLboolean normalized, T value_t<value_type>::*member, GLuint divisor = 0) {
+            if(direct_state_access()) {
+                vao.attribute<T>(location, normalized, member_offset(member), location);
+                vao.bind_vertex_buffer(location, m_handle, 0, sizeof(value_type));
+                vao.binding_divisor(location, divisor);
+            } else {
+                vao.bind();
+                bind();
+                vertex_pointer(location, normalized, member, divisor);
             }
         }
         [[nodiscard]] GLuint handle() const noexcept {
             return m_handle;
         }
         void bind() {
-            glBindBuffer(buffer_target, m_handle);
+            current_state().bind_buffer(buffer_target, m_handle);
         }
         void unbind() {
-            glBindBuffer(buffer_target, 0);
+            current_state().bind_buffer(buffer_target, 0);
         }
         template <class Iterator>
         auto modify(std::ptrdiff_t offset, const Iterator& begin, const Iterator& end) -> std::enable_if_t<is_input_iterator_v<Iterator>> {
-            bind();
             std::vector<value_type> data(begin, end);
             modify(offset, data.begin(), data.end());
         }
         template <class Iterator>
         auto modify(std::ptrdiff_t offset, const Iterator& begin, const Iterator& end) -> std::enable_if_t<is_random_access_iterator_v<Iterator>> {
-            bind();
             auto size = std::distance(begin, end);
-            glBufferSubData(buffer_target, offset * sizeof(value_type), sizeof(value_type) * (size + offset >= m_size ? m_size - offset : size), &*begin);
+            if(size > 0) modify(offset, &*begin, size);
         }
         template <class Iterator>
         void modify(const Iterator& begin, const Iterator& end) {
             modify(0, begin, end);
         }
-        template <class Iterator>
-        auto extend(std::ptrdiff_t offset, const Iterator& begin, const Iterator& end) {
-            auto size = std::distance(begin, end) + offset;
-            auto expect_size = size;
+        void modify(std::ptrdiff_t offset, const value_type* data, std::size_t size) {
+            if(offset >= m_size) return;
+            auto bytes = sizeof(value_type) * (size + offset > m_size ? m_size - offset : size);
+            current_barriers().use(m_handle, GL_BUFFER_UPDATE_BARRIER_BIT);
+            if(direct_state_access()) {
+                glNamedBufferSubData(m_handle, offset * sizeof(value_type), bytes, data);
+            } else {
+                bind();
+                glBufferSubData(buffer_target, offset * sizeof(value_type), bytes, data);
+            }
+            profile_upload(bytes);
+        }
+        void modify(std::ptrdiff_t offset, span<const value_type> data) {
+            modify(offset, data.data(), data.size());
+        }
+        void modify(span<const value_type> data) {
+            modify(0, data.data(), data.size());
+        }
+        template <class Iterator, class GrowthPolicy=power_of_two_growth>
+        auto extend(std::ptrdiff_t offset, const Iterator& begin, const Iterator& end, GrowthPolicy policy = GrowthPolicy{}) {
+            std::size_t size = std::distance(begin, end) + offset;
             if(size > m_capacity) {
-                for(std::size_t i = 1; i != expect_size; ) {
-                    if(i < expect_size) i <<= 1;
-                    if(i > expect_size) expect_size = i;
-                }
-                GLuint vbo;
-                glGenBuffers(1, &vbo);
-                glBindBuffer(buffer_target, vbo);
-                glBufferData(buffer_target, m_size * sizeof(value_type), nullptr, buffer_usage);
-                glBindBuffer(GL_COPY_READ_BUFFER, m_handle);
-                glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
-                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, m_size * sizeof(value_type));
-                glBindBuffer(buffer_target, m_handle);
-                glBufferData(buffer_target, expect_size * sizeof(value_type), nullptr, buffer_usage);
-                glBindBuffer(GL_COPY_READ_BUFFER, vbo);
-                glBindBuffer(GL_COPY_WRITE_BUFFER, m_handle);
-                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, m_size * sizeof(value_type));
-                glDeleteBuffers(1, &vbo);
-                m_capacity = expect_size;
+                reallocate(std::max<std::size_t>(policy(m_capacity, size), size));
             }
             m_size = size;
             modify(offset, begin, end);
         }
-        template <class Iterator>
-        auto extend(const Iterator& begin, const Iterator& end) {
-            extend(m_size, begin, end);
+        template <class Iterator, class GrowthPolicy=power_of_two_growth>
+        auto extend(const Iterator& begin, const Iterator& end, GrowthPolicy policy = GrowthPolicy{}) {
+            extend(m_size, begin, end, policy);
+        }
+        template <class GrowthPolicy=power_of_two_growth>
+        void extend(std::ptrdiff_t offset, const value_type* data, std::size_t size, GrowthPolicy policy = GrowthPolicy{}) {
+            extend(offset, data, data + size, policy);
+        }
+        template <class GrowthPolicy=power_of_two_growth>
+        void extend(std::ptrdiff_t offset, span<const value_type> data, GrowthPolicy policy = GrowthPolicy{}) {
+            extend(offset, data.begin(), data.end(), policy);
+        }
+        template <class GrowthPolicy=power_of_two_growth>
+        void extend(span<const value_type> data, GrowthPolicy policy = GrowthPolicy{}) {
+            extend(m_size, data.begin(), data.end(), policy);
+        }
+        void reserve(std::size_t capacity) {
+            if(capacity <= m_capacity) return;
+            if(m_size == 0) {
+                if(direct_state_access()) {
+                    glNamedBufferData(m_handle, capacity * sizeof(value_type), nullptr, buffer_usage);
+                } else {
+                    bind();
+                    glBufferData(buffer_target, capacity * sizeof(value_type), nullptr, buffer_usage);
+                }
+                m_capacity = capacity;
+            } else {
+                reallocate(capacity);
+            }
         }
         [[nodiscard]] std::size_t size() const noexcept {
             return m_size;
@@ -195,7 +276,6 @@ namespace gl {
         }
         template <class Iterator>
         auto get(std::ptrdiff_t offset, const Iterator& begin, const Iterator& end) -> std::enable_if_t<is_input_iterator_v<Iterator>> {
-            bind();
             auto size = std::distance(begin, end);
             std::vector<value_type> data(size);
             get(offset, data.begin(), data.end());
@@ -203,17 +283,75 @@ namespace gl {
         }
         template <class Iterator>
         auto get(std::ptrdiff_t offset, const Iterator& begin, const Iterator& end) -> std::enable_if_t<is_random_access_iterator_v<Iterator>> {
-            bind();
-            if(offset >= m_size) return;
-            else {
-                auto size = std::distance(begin, end);
-                glGetBufferSubData(buffer_target, offset * sizeof(value_type), sizeof(value_type) * (size + offset > m_size ? m_size - offset : size), &*begin);
-            }
+            auto size = std::distance(begin, end);
+            if(size > 0) get(offset, &*begin, size);
         }
         template <class Iterator>
         void get(const Iterator& begin, const Iterator& end) {
             get(0, begin, end);
         }
+        void get(std::ptrdiff_t offset, value_type* data, std::size_t size) {
+            if(offset >= m_size) return;
+            else {
+                auto bytes = sizeof(value_type) * (size + offset > m_size ? m_size - offset : size);
+                // results of compute shaders written to this buffer
+                current_barriers().use(m_handle, GL_BUFFER_UPDATE_BARRIER_BIT);
+                if(direct_state_access()) {
+                    glGetNamedBufferSubData(m_handle, offset * sizeof(value_type), bytes, data);
+                } else {
+                    bind();
+                    glGetBufferSubData(buffer_target, offset * sizeof(value_type), bytes, data);
+                }
+                profile_read(bytes);
+            }
+        }
+        void get(std::ptrdiff_t offset, span<value_type> data) {
+            get(offset, data.data(), data.size());
+        }
+        void get(span<value_type> data) {
+            get(0, data.data(), data.size());
+        }
+    private:
+        void allocate(const value_type* data) {
+            m_handle = create(m_capacity, data);
+        }
+        // moves the contents into new storage with one copy and takes over its handle
+        void reallocate(std::size_t capacity) {
+            GLuint vbo = create(capacity, nullptr);
+            current_barriers().use(m_handle, GL_BUFFER_UPDATE_BARRIER_BIT);
+            if(direct_state_access()) {
+                glCopyNamedBufferSubData(m_handle, vbo, 0, 0, m_size * sizeof(value_type));
+            } else {
+                current_state().bind_buffer(GL_COPY_WRITE_BUFFER, vbo);
+                current_state().bind_buffer(GL_COPY_READ_BUFFER, m_handle);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, m_size * sizeof(value_type));
+            }
+            current_barriers().moved(m_handle, vbo);
+            delete_buffer(m_handle, m_capacity * sizeof(value_type), buffer_usage);
+            m_handle = vbo;
+            m_capacity = capacity;
+        }
+        // reuses a retired buffer of the same size when the deletion queue has one
+        static GLuint create(std::size_t capacity, const value_type* data) {
+            GLuint handle = current_deletion_queue().recycle_buffer(capacity * sizeof(value_type), buffer_usage);
+            if(handle) {
+                if(direct_state_access()) {
+                    if(data) glNamedBufferSubData(handle, 0, capacity * sizeof(value_type), data);
+                } else {
+                    current_state().bind_buffer(buffer_target, handle);
+                    if(data) glBufferSubData(buffer_target, 0, capacity * sizeof(value_type), data);
+                }
+            } else if(direct_state_access()) {
+                glCreateBuffers(1, &handle);
+                glNamedBufferData(handle, capacity * sizeof(value_type), data, buffer_usage);
+            } else {
+                glGenBuffers(1, &handle);
+                current_state().bind_buffer(buffer_target, handle);
+                glBufferData(buffer_target, capacity * sizeof(value_type), data, buffer_usage);
+            }
+            if(data) profile_upload(capacity * sizeof(value_type));
+            return handle;
+        }
     private:
         std::size_t m_size;
         std::size_t m_capacity;
@@ -0,0 +1,92 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+
+#ifndef GL_VERTEX_LAYOUT_H
+#define GL_VERTEX_LAYOUT_H
+
+#include <cstddef>
+
+#include <GL/glew.h>
+
+#include "gl++/primitive_type.h"
+#include "gl++/vertex_array.h"
+#include "gl++/vertex_buffer.h"
+
+namespace gl {
+    // Offset is expected to be offsetof(Vertex, member)
+    template <class T, std::size_t Offset, GLuint Location, GLboolean Normalized = GL_FALSE, GLuint Divisor = 0>
+    struct vertex_attribute {
+        using value_type = T;
+        static constexpr std::size_t offset = Offset;
+        static constexpr GLuint location = Location;
+        static constexpr GLboolean normalized = Normalized || is_normalized_attribute_v<std::remove_cv_t<typename gl_primitive_type<T>::type>>;
+        static constexpr GLuint divisor = Divisor;
+        static constexpr GLint components = attribute_components<T>;
+        static constexpr GLenum type = gl_primitive_type<T>::value;
+    };
+
+    template <class Vertex, class... Attributes>
+    class vertex_layout {
+    public:
+        using vertex_type = Vertex;
+        static constexpr GLsizei stride = sizeof(Vertex);
+        static constexpr std::size_t attribute_count = sizeof...(Attributes);
+    private:
+        static constexpr bool unique_locations() {
+            // a matrix attribute takes one location per column
+            constexpr GLuint first[] = { Attributes::location... };
+            constexpr GLuint last[] = { (Attributes::location + attribute_locations<typename Attributes::value_type>)... };
+            for(std::size_t i = 0; i < attribute_count; i++) {
+                for(std::size_t j = i + 1; j < attribute_count; j++) {
+                    if(first[i] < last[j] && first[j] < last[i]) return false;
+                }
+            }
+            return true;
+        }
+        static constexpr GLuint divisor() {
+            constexpr GLuint divisors[] = { Attributes::divisor... };
+            return divisors[0];
+        }
+        static_assert(attribute_count > 0, "vertex layout needs at least one attribute");
+        static_assert(((Attributes::offset + sizeof(typename Attributes::value_type) <= sizeof(Vertex)) && ...), "attribute lies outside of the vertex");
+        static_assert(unique_locations(), "attribute locations must be unique");
+        static_assert(((Attributes::divisor == divisor()) && ...), "attributes sharing a binding must share the divisor");
+    public:
+        // sets up the attribute formats of vao and connects them to the binding point
+        static void apply(const vertex_array& vao, GLuint binding = 0) {
+            (vao.attribute<typename Attributes::value_type>(Attributes::location, Attributes::normalized, Attributes::offset, binding), ...);
+            vao.binding_divisor(binding, divisor());
+        }
+        template <class Traits>
+        static void apply(const vertex_array& vao, const vertex_buffer<Traits>& buffer, GLuint binding = 0) {
+            static_assert(std::is_same_v<typename Traits::value_type, Vertex>);
+            apply(vao, binding);
+            vao.bind_vertex_buffer(binding, buffer.handle(), 0, stride);
+        }
+    };
+
+    // vertex array shared by every buffer with Layout. it belongs to the context current when it is created,
+    // so keep one per context and destroy it before that context.
+    template <class Layout>
+    class shared_vertex_array {
+    public:
+        shared_vertex_array() : m_vao() {
+            Layout::apply(m_vao);
+        }
+        // switching meshes is a single glBindVertexBuffer once the vertex array is bound
+        template <class Traits>
+        void bind(const vertex_buffer<Traits>& buffer, GLuint binding = 0) const {
+            static_assert(std::is_same_v<typename Traits::value_type, typename Layout::vertex_type>);
+            m_vao.bind();
+            m_vao.bind_vertex_buffer(binding, buffer.handle(), 0, Layout::stride);
+        }
+        [[nodiscard]] const vertex_array& array() const noexcept {
+            return m_vao;
+        }
+    private:
+        vertex_array m_vao;
+    };
+}
+
+#endif //GL_VERTEX_LAYOUT_H
@@ -0,0 +1,58 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+#include "gl++/background_uploader.h"
+
+gl::background_uploader::background_uploader(std::function<void()> make_current, std::function<void()> release)
+    : m_make_current(std::move(make_current)), m_release(std::move(release)), m_running(0), m_stop(false) {
+    m_thread = std::thread([this]() { run(); });
+}
+
+gl::background_uploader::~background_uploader() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+}
+
+void gl::background_uploader::flush() {
+    std::unique_lock lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_jobs.empty() && m_running == 0; });
+}
+
+std::size_t gl::background_uploader::pending() const {
+    std::lock_guard lock(m_mutex);
+    return m_jobs.size() + m_running;
+}
+
+void gl::background_uploader::enqueue(std::function<void()> job) {
+    {
+        std::lock_guard lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+void gl::background_uploader::run() {
+    if(m_make_current) m_make_current();
+    while(true) {
+        std::function<void()> job;
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+            if(m_jobs.empty()) break;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_running++;
+        }
+        job();
+        {
+            std::lock_guard lock(m_mutex);
+            m_running--;
+        }
+        m_idle.notify_all();
+    }
+    if(m_release) m_release();
+}
@@ -0,0 +1,169 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+#include "gl++/buffer_arena.h"
+
+#include <algorithm>
+
+#include "gl++/deletion_queue.h"
+#include "gl++/direct_state_access.h"
+#include "gl++/memory_barrier.h"
+#include "gl++/state_cache.h"
+
+namespace {
+    std::size_t align_up(std::size_t value, std::size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+gl::buffer_arena::buffer_arena(GLenum target, GLenum usage, std::size_t block_size, std::size_t alignment)
+    : m_target(target), m_usage(usage), m_block_size(block_size), m_alignment(std::max<std::size_t>(alignment, 1)) {}
+
+gl::buffer_arena::~buffer_arena() {
+    for(auto& b : m_blocks) {
+        delete_buffer(b.handle, b.size, m_usage);
+    }
+}
+
+gl::buffer_arena::allocation_id gl::buffer_arena::allocate(std::size_t size, std::size_t alignment) {
+    record r { 0, 0, std::max<std::size_t>(size, 1), std::lcm(std::max<std::size_t>(alignment, 1), m_alignment), true };
+    bool found = false;
+    for(std::size_t i = 0; i < m_blocks.size() && !found; i++) {
+        found = allocate_from(i, r);
+    }
+    if(!found) {
+        auto block_size = std::max(m_block_size, r.size);
+        m_blocks.push_back(block { create_buffer(block_size), block_size, { free_range { 0, block_size } } });
+        allocate_from(m_blocks.size() - 1, r);
+    }
+    if(!m_free_records.empty()) {
+        auto id = m_free_records.back();
+        m_free_records.pop_back();
+        m_records[id] = r;
+        return id;
+    }
+    m_records.push_back(r);
+    return m_records.size() - 1;
+}
+
+void gl::buffer_arena::deallocate(allocation_id id) {
+    auto& r = m_records[id];
+    if(!r.live) return;
+    release(r.block, r.offset, r.size);
+    r.live = false;
+    m_free_records.push_back(id);
+}
+
+void gl::buffer_arena::defragment() {
+    for(std::size_t i = 0; i < m_blocks.size(); i++) {
+        auto& b = m_blocks[i];
+        // already compact when the only free range is the tail
+        if(b.free_list.empty() || (b.free_list.size() == 1 && b.free_list.front().offset + b.free_list.front().size == b.size)) continue;
+
+        std::vector<record*> live;
+        for(auto& r : m_records) {
+            if(r.live && r.block == i) live.push_back(&r);
+        }
+        std::sort(live.begin(), live.end(), [](const record* a, const record* b) { return a->offset < b->offset; });
+
+        GLuint handle = create_buffer(b.size);
+        current_barriers().use(b.handle, GL_BUFFER_UPDATE_BARRIER_BIT);
+        if(!direct_state_access()) {
+            current_state().bind_buffer(GL_COPY_READ_BUFFER, b.handle);
+            current_state().bind_buffer(GL_COPY_WRITE_BUFFER, handle);
+        }
+        std::size_t end = 0;
+        for(auto r : live) {
+            auto offset = align_up(end, r->alignment);
+            if(direct_state_access()) {
+                glCopyNamedBufferSubData(b.handle, handle, r->offset, offset, r->size);
+            } else {
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, r->offset, offset, r->size);
+            }
+            r->offset = offset;
+            end = offset + r->size;
+        }
+        current_barriers().moved(b.handle, handle);
+        delete_buffer(b.handle, b.size, m_usage);
+        b.handle = handle;
+        b.free_list.clear();
+        if(end < b.size) b.free_list.push_back(free_range { end, b.size - end });
+    }
+}
+
+GLuint gl::buffer_arena::handle(allocation_id id) const {
+    return m_blocks[m_records[id].block].handle;
+}
+
+std::size_t gl::buffer_arena::offset(allocation_id id) const {
+    return m_records[id].offset;
+}
+
+std::size_t gl::buffer_arena::size(allocation_id id) const {
+    return m_records[id].size;
+}
+
+GLenum gl::buffer_arena::target() const noexcept {
+    return m_target;
+}
+
+gl::buffer_arena::statistics gl::buffer_arena::stats() const noexcept {
+    statistics s { m_blocks.size(), 0, 0, m_records.size() - m_free_records.size(), 0, 0 };
+    for(const auto& b : m_blocks) {
+        s.capacity += b.size;
+        s.free_ranges += b.free_list.size();
+        for(const auto& f : b.free_list) {
+            s.largest_free = std::max(s.largest_free, f.size);
+        }
+    }
+    for(const auto& r : m_records) {
+        if(r.live) s.used += r.size;
+    }
+    return s;
+}
+
+bool gl::buffer_arena::allocate_from(std::size_t block_index, record& r) {
+    auto& free_list = m_blocks[block_index].free_list;
+    for(auto it = free_list.begin(); it != free_list.end(); ++it) {
+        auto offset = align_up(it->offset, r.alignment);
+        if(offset + r.size > it->offset + it->size) continue;
+        auto before = free_range { it->offset, offset - it->offset };
+        auto after = free_range { offset + r.size, it->offset + it->size - offset - r.size };
+        it = free_list.erase(it);
+        if(after.size) it = free_list.insert(it, after);
+        if(before.size) free_list.insert(it, before);
+        r.block = block_index;
+        r.offset = offset;
+        return true;
+    }
+    return false;
+}
+
+void gl::buffer_arena::release(std::size_t block_index, std::size_t offset, std::size_t size) {
+    auto& free_list = m_blocks[block_index].free_list;
+    auto it = std::lower_bound(free_list.begin(), free_list.end(), offset, [](const free_range& f, std::size_t offset) { return f.offset < offset; });
+    it = free_list.insert(it, free_range { offset, size });
+    // coalesce with the following range, then with the preceding one
+    if(std::next(it) != free_list.end() && it->offset + it->size == std::next(it)->offset) {
+        it->size += std::next(it)->size;
+        free_list.erase(std::next(it));
+    }
+    if(it != free_list.begin() && std::prev(it)->offset + std::prev(it)->size == it->offset) {
+        std::prev(it)->size += it->size;
+        free_list.erase(it);
+    }
+}
+
+GLuint gl::buffer_arena::create_buffer(std::size_t size) const {
+    GLuint handle = current_deletion_queue().recycle_buffer(size, m_usage);
+    if(handle) return handle;
+    if(direct_state_access()) {
+        glCreateBuffers(1, &handle);
+        glNamedBufferData(handle, size, nullptr, m_usage);
+    } else {
+        glGenBuffers(1, &handle);
+        current_state().bind_buffer(GL_COPY_WRITE_BUFFER, handle);
+        glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, m_usage);
+    }
+    return handle;
+}
@@ -0,0 +1,179 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+#include "gl++/command_queue.h"
+
+#include <algorithm>
+#include <cstdint>
+
+gl::command_arena::command_arena(std::size_t chunk_size) : m_chunk_size(chunk_size), m_chunk(0), m_offset(0) {}
+
+void* gl::command_arena::allocate(std::size_t size, std::size_t alignment) {
+    for(; m_chunk < m_chunks.size(); m_chunk++, m_offset = 0) {
+        auto& c = m_chunks[m_chunk];
+        auto address = reinterpret_cast<std::uintptr_t>(c.data.get());
+        auto offset = (address + m_offset + alignment - 1) / alignment * alignment - address;
+        if(offset + size <= c.size) {
+            m_offset = offset + size;
+            return c.data.get() + offset;
+        }
+    }
+    // operator new[] aligns to __STDCPP_DEFAULT_NEW_ALIGNMENT__, so larger alignments get padding
+    auto chunk_size = std::max(m_chunk_size, size + alignment);
+    m_chunks.push_back(chunk { std::make_unique<std::byte[]>(chunk_size), chunk_size });
+    m_chunk = m_chunks.size() - 1;
+    m_offset = 0;
+    return allocate(size, alignment);
+}
+
+void gl::command_arena::reset() noexcept {
+    m_chunk = 0;
+    m_offset = 0;
+}
+
+std::size_t gl::command_arena::capacity() const noexcept {
+    std::size_t capacity = 0;
+    for(const auto& c : m_chunks) {
+        capacity += c.size;
+    }
+    return capacity;
+}
+
+gl::command_list::command_list(command_queue& queue) : m_queue(&queue), m_next(nullptr), m_next_owned(nullptr) {}
+
+gl::command_list::~command_list() {
+    reset();
+}
+
+gl::pending<gl::vertex_array> gl::command_list::create_vertex_array() {
+    return create<vertex_array>([](std::optional<vertex_array>& object) {
+        object.emplace();
+    });
+}
+
+gl::pending<gl::shader_program> gl::command_list::build_program(const std::vector<shader_source>& sources) {
+    auto stored = static_cast<stored_source*>(m_arena.allocate(sizeof(stored_source) * sources.size(), alignof(stored_source)));
+    for(std::size_t i = 0; i < sources.size(); i++) {
+        stored[i] = stored_source { store(sources[i].source), sources[i].type };
+    }
+    auto copy = span<const stored_source>(stored, sources.size());
+    return create<shader_program>([copy](std::optional<shader_program>& object) {
+        auto& program = object.emplace();
+        bool built = true;
+        for(const auto& [source, type] : copy) {
+            built = built && program.add_shader(std::string(source), type);
+        }
+        if(!built || !program.link()) program.reset();
+    });
+}
+
+std::size_t gl::command_list::size() const noexcept {
+    return m_commands.size();
+}
+
+bool gl::command_list::empty() const noexcept {
+    return m_commands.empty();
+}
+
+std::string_view gl::command_list::store(std::string_view text) {
+    auto p = static_cast<char*>(m_arena.allocate(text.size(), 1));
+    std::memcpy(p, text.data(), text.size());
+    return std::string_view(p, text.size());
+}
+
+void gl::command_list::replay() {
+    for(auto& c : m_commands) {
+        c.invoke(c.function);
+    }
+}
+
+void gl::command_list::reset() noexcept {
+    for(auto& c : m_commands) {
+        c.destroy(c.function);
+    }
+    m_commands.clear();
+    m_arena.reset();
+}
+
+gl::command_queue::command_queue() : m_submitted(nullptr), m_free(nullptr), m_owned(nullptr), m_disposals(nullptr),
+        m_lists(0), m_gl_thread(std::this_thread::get_id()), m_ready_begin(0) {}
+
+gl::command_queue::~command_queue() {
+    // unreplayed commands are dropped
+    auto list = m_owned.exchange(nullptr);
+    while(list) {
+        auto next = list->m_next_owned;
+        delete list;
+        list = next;
+    }
+    auto node = m_disposals.exchange(nullptr);
+    while(node) {
+        auto next = node->next;
+        node->destroy(node->object);
+        delete node;
+        node = next;
+    }
+}
+
+gl::command_list& gl::command_queue::acquire() {
+    // taking the whole free stack and pushing the rest back avoids the ABA problem of a lock-free pop
+    auto list = m_free.exchange(nullptr, std::memory_order_acquire);
+    if(list) {
+        if(auto rest = list->m_next) {
+            auto last = rest;
+            while(last->m_next) last = last->m_next;
+            push<command_list, &command_list::m_next>(m_free, rest, last);
+        }
+        list->m_next = nullptr;
+        return *list;
+    }
+    list = new command_list(*this);
+    push<command_list, &command_list::m_next_owned>(m_owned, list, list);
+    m_lists.fetch_add(1, std::memory_order_relaxed);
+    return *list;
+}
+
+void gl::command_queue::submit(command_list& list) {
+    push<command_list, &command_list::m_next>(m_submitted, &list, &list);
+}
+
+std::size_t gl::command_queue::replay(std::size_t max_lists) {
+    m_gl_thread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
+    auto node = m_disposals.exchange(nullptr, std::memory_order_acquire);
+    while(node) {
+        auto next = node->next;
+        node->destroy(node->object);
+        delete node;
+        node = next;
+    }
+
+    // the stack holds the newest list first
+    auto first = m_ready.size();
+    for(auto list = m_submitted.exchange(nullptr, std::memory_order_acquire); list; list = list->m_next) {
+        m_ready.push_back(list);
+    }
+    std::reverse(m_ready.begin() + first, m_ready.end());
+
+    std::size_t count = 0;
+    while(m_ready_begin < m_ready.size() && count < max_lists) {
+        auto list = m_ready[m_ready_begin++];
+        list->replay();
+        list->reset();
+        push<command_list, &command_list::m_next>(m_free, list, list);
+        count++;
+    }
+    if(m_ready_begin == m_ready.size()) {
+        m_ready.clear();
+        m_ready_begin = 0;
+    }
+    return count;
+}
+
+std::size_t gl::command_queue::lists() const noexcept {
+    return m_lists.load(std::memory_order_relaxed);
+}
+
+bool gl::command_queue::on_gl_thread() const noexcept {
+    return m_gl_thread.load(std::memory_order_relaxed) == std::this_thread::get_id();
+}
@@ -0,0 +1,118 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+#include "gl++/compute_pipeline.h"
+
+#include <algorithm>
+
+#include "gl++/state_cache.h"
+
+gl::compute_pipeline::compute_pipeline(shader_program program) : m_program(std::move(program)), m_work_group_size { 0, 0, 0 } {
+    if(!m_program.enabled()) return;
+    GLint linked = GL_FALSE;
+    glGetProgramiv(m_program.handle(), GL_LINK_STATUS, &linked);
+    if(linked != GL_TRUE) return;
+    // the query fails with GL_INVALID_OPERATION on programs without a compute shader and leaves size untouched
+    GLint size[3] = { 0, 0, 0 };
+    glGetProgramiv(m_program.handle(), GL_COMPUTE_WORK_GROUP_SIZE, size);
+    if(size[0] == 0) {
+        glGetError();
+        return;
+    }
+    for(int i = 0; i < 3; i++) m_work_group_size[i] = static_cast<GLuint>(size[i]);
+
+    for(const auto& resource : m_program.resources()) {
+        if(resource.program_interface == GL_SHADER_STORAGE_BLOCK) {
+            m_blocks.push_back(block { resource.hash, resource.index, static_cast<GLuint>(resource.location) });
+        }
+    }
+    // blocks without a binding qualifier all sit on point 0, so they get one each
+    std::vector<GLuint> points;
+    for(const auto& b : m_blocks) points.push_back(b.point);
+    std::sort(points.begin(), points.end());
+    if(std::adjacent_find(points.begin(), points.end()) != points.end()) {
+        for(GLuint i = 0; i < m_blocks.size(); i++) {
+            m_blocks[i].point = i;
+            glShaderStorageBlockBinding(m_program.handle(), m_blocks[i].index, i);
+        }
+        // keeps storage_block() of the program in line with the new points
+        m_program.reflect();
+    }
+}
+
+bool gl::compute_pipeline::valid() const noexcept {
+    return m_work_group_size[0] != 0;
+}
+
+const gl::shader_program& gl::compute_pipeline::program() const noexcept {
+    return m_program;
+}
+
+const std::array<GLuint, 3>& gl::compute_pipeline::work_group_size() const noexcept {
+    return m_work_group_size;
+}
+
+GLint gl::compute_pipeline::binding_point(name_hash block) const noexcept {
+    auto it = std::find_if(m_blocks.begin(), m_blocks.end(), [block](const struct block& b) { return b.name == block; });
+    return it == m_blocks.end() ? -1 : static_cast<GLint>(it->point);
+}
+
+bool gl::compute_pipeline::bind(name_hash block, GLuint buffer, buffer_access access, GLintptr offset, GLsizeiptr size) {
+    auto point = binding_point(block);
+    if(point < 0) return false;
+    auto it = std::find_if(m_bindings.begin(), m_bindings.end(), [point](const binding& b) { return b.point == static_cast<GLuint>(point); });
+    if(it == m_bindings.end()) {
+        m_bindings.push_back(binding { static_cast<GLuint>(point), buffer, access, offset, size });
+    } else {
+        *it = binding { static_cast<GLuint>(point), buffer, access, offset, size };
+    }
+    return true;
+}
+
+bool gl::compute_pipeline::unbind(name_hash block) {
+    auto point = binding_point(block);
+    if(point < 0) return false;
+    m_bindings.erase(std::remove_if(m_bindings.begin(), m_bindings.end(), [point](const binding& b) { return b.point == static_cast<GLuint>(point); }), m_bindings.end());
+    return true;
+}
+
+void gl::compute_pipeline::dispatch(GLuint groups_x, GLuint groups_y, GLuint groups_z) {
+    before_dispatch();
+    current_barriers().flush();
+    glDispatchCompute(groups_x, groups_y, groups_z);
+    after_dispatch();
+}
+
+void gl::compute_pipeline::dispatch_invocations(GLuint x, GLuint y, GLuint z) {
+    auto groups = [](GLuint count, GLuint size) { return size == 0 ? 0 : (count + size - 1) / size; };
+    dispatch(groups(x, m_work_group_size[0]), groups(y, m_work_group_size[1]), groups(z, m_work_group_size[2]));
+}
+
+void gl::compute_pipeline::dispatch_indirect(GLuint commands, GLintptr offset) {
+    before_dispatch();
+    // the commands may have been written by an earlier dispatch
+    current_barriers().require(commands, GL_COMMAND_BARRIER_BIT);
+    current_barriers().flush();
+    current_state().bind_buffer(GL_DISPATCH_INDIRECT_BUFFER, commands);
+    glDispatchComputeIndirect(offset);
+    after_dispatch();
+}
+
+void gl::compute_pipeline::before_dispatch() {
+    m_program.use();
+    for(const auto& b : m_bindings) {
+        // reads need the earlier writes to be visible, writes must not land before them either
+        current_barriers().require(b.buffer, GL_SHADER_STORAGE_BARRIER_BIT);
+        if(b.size > 0) {
+            current_state().bind_buffer_range(GL_SHADER_STORAGE_BUFFER, b.point, b.buffer, b.offset, b.size);
+        } else {
+            current_state().bind_buffer_base(GL_SHADER_STORAGE_BUFFER, b.point, b.buffer);
+        }
+    }
+}
+
+void gl::compute_pipeline::after_dispatch() {
+    for(const auto& b : m_bindings) {
+        if(b.access != buffer_access::read) current_barriers().written(b.buffer);
+    }
+}
@@ -0,0 +1,177 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+#include "gl++/deletion_queue.h"
+
+#include <iterator>
+
+#include "gl++/memory_barrier.h"
+#include "gl++/state_cache.h"
+
+gl::deletion_queue::deletion_queue() noexcept : m_deferred(false), m_recycle_limit(16), m_recycled(0), m_deleted(0) {}
+
+void gl::deletion_queue::set_deferred(bool deferred) noexcept {
+    m_deferred = deferred;
+}
+
+bool gl::deletion_queue::deferred() const noexcept {
+    return m_deferred;
+}
+
+void gl::deletion_queue::retire_buffer(GLuint handle, std::size_t size, GLenum usage) {
+    retire(retired_object { object_type::buffer, handle, size, usage });
+}
+
+void gl::deletion_queue::retire_vertex_array(GLuint handle) {
+    retire(retired_object { object_type::vertex_array, handle, 0, 0 });
+}
+
+void gl::deletion_queue::retire_program(GLuint handle) {
+    retire(retired_object { object_type::program, handle, 0, 0 });
+}
+
+GLuint gl::deletion_queue::recycle_buffer(std::size_t size, GLenum usage) {
+    // newest first, its storage is the most likely to be resident
+    for(auto it = m_recyclable.rbegin(); it != m_recyclable.rend(); ++it) {
+        if(it->size == size && it->usage == usage) {
+            auto handle = it->handle;
+            m_recyclable.erase(std::next(it).base());
+            m_recycled++;
+            return handle;
+        }
+    }
+    return 0;
+}
+
+void gl::deletion_queue::end_frame() {
+    if(!m_current.empty()) {
+        m_frames.push_back(frame { glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), std::move(m_current) });
+        m_current.clear();
+    }
+    collect();
+}
+
+void gl::deletion_queue::collect() {
+    // frames complete in submission order
+    while(!m_frames.empty()) {
+        auto status = glClientWaitSync(m_frames.front().fence, 0, 0);
+        if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+        glDeleteSync(m_frames.front().fence);
+        for(const auto& object : m_frames.front().objects) {
+            release(object);
+        }
+        m_frames.pop_front();
+    }
+}
+
+void gl::deletion_queue::flush() {
+    for(auto& f : m_frames) {
+        glDeleteSync(f.fence);
+        for(const auto& object : f.objects) {
+            destroy(object);
+        }
+    }
+    m_frames.clear();
+    for(const auto& object : m_current) {
+        destroy(object);
+    }
+    m_current.clear();
+    for(const auto& object : m_recyclable) {
+        destroy(object);
+    }
+    m_recyclable.clear();
+}
+
+void gl::deletion_queue::set_recycle_limit(std::size_t limit) {
+    m_recycle_limit = limit;
+    while(m_recyclable.size() > m_recycle_limit) {
+        destroy(m_recyclable.front());
+        m_recyclable.pop_front();
+    }
+}
+
+std::size_t gl::deletion_queue::recycle_limit() const noexcept {
+    return m_recycle_limit;
+}
+
+std::size_t gl::deletion_queue::pending() const noexcept {
+    auto count = m_current.size();
+    for(const auto& f : m_frames) {
+        count += f.objects.size();
+    }
+    return count;
+}
+
+std::size_t gl::deletion_queue::recyclable() const noexcept {
+    return m_recyclable.size();
+}
+
+std::size_t gl::deletion_queue::recycled() const noexcept {
+    return m_recycled;
+}
+
+std::size_t gl::deletion_queue::deleted() const noexcept {
+    return m_deleted;
+}
+
+void gl::deletion_queue::reset_statistics() noexcept {
+    m_recycled = 0;
+    m_deleted = 0;
+}
+
+void gl::deletion_queue::retire(const retired_object& object) {
+    if(m_deferred) {
+        m_current.push_back(object);
+    } else {
+        destroy(object);
+    }
+}
+
+void gl::deletion_queue::release(const retired_object& object) {
+    if(object.type != object_type::buffer || object.usage == 0 || m_recycle_limit == 0) {
+        destroy(object);
+        return;
+    }
+    if(m_recyclable.size() >= m_recycle_limit) {
+        destroy(m_recyclable.front());
+        m_recyclable.pop_front();
+    }
+    m_recyclable.push_back(object);
+}
+
+void gl::deletion_queue::destroy(const retired_object& object) {
+    switch(object.type) {
+        case object_type::buffer:
+            current_state().forget_buffer(object.handle);
+            glDeleteBuffers(1, &object.handle);
+            break;
+        case object_type::vertex_array:
+            current_state().forget_vertex_array(object.handle);
+            glDeleteVertexArrays(1, &object.handle);
+            break;
+        case object_type::program:
+            glDeleteProgram(object.handle);
+            break;
+    }
+    m_deleted++;
+}
+
+gl::deletion_queue& gl::current_deletion_queue() {
+    thread_local deletion_queue queue;
+    return queue;
+}
+
+void gl::delete_buffer(GLuint handle, std::size_t size, GLenum usage) {
+    if(!handle) return;
+    // writes to a retired buffer need no barrier, and its name may come back for another buffer
+    current_barriers().forget(handle);
+    current_deletion_queue().retire_buffer(handle, size, usage);
+}
+
+void gl::delete_vertex_array(GLuint handle) {
+    if(handle) current_deletion_queue().retire_vertex_array(handle);
+}
+
+void gl::delete_program(GLuint handle) {
+    if(handle) current_deletion_queue().retire_program(handle);
+}
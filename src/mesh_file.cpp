@@ -0,0 +1,313 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+#include "gl++/mesh_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "gl++/direct_state_access.h"
+#include "gl++/profiler.h"
+#include "gl++/state_cache.h"
+
+namespace {
+    constexpr char magic[4] = { 'G', 'L', 'P', 'M' };
+    // chunk data starts on page boundaries, so uploaded chunks can be dropped from memory exactly
+    constexpr std::uint64_t chunk_alignment = 4096;
+
+    struct file_header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t vertex_stride;
+        std::uint32_t index_type;
+        std::uint64_t vertex_count;
+        std::uint64_t index_count;
+        std::uint32_t attribute_count;
+        std::uint32_t chunk_count;
+    };
+
+    std::size_t index_size(std::uint32_t type) {
+        switch(type) {
+            case GL_UNSIGNED_BYTE: return 1;
+            case GL_UNSIGNED_SHORT: return 2;
+            case GL_UNSIGNED_INT: return 4;
+            default: return 0;
+        }
+    }
+
+    // read-only mapping of the whole file, nullptr if it cannot be mapped or is smaller than min_size.
+    // the mapping keeps its own reference to the file, so no handle stays open.
+#ifdef _WIN32
+    std::byte* map_file(const std::string& path, std::size_t min_size, std::size_t& size) {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if(file == INVALID_HANDLE_VALUE) return nullptr;
+        void* data = nullptr;
+        LARGE_INTEGER file_size {};
+        if(GetFileSizeEx(file, &file_size) && static_cast<std::uint64_t>(file_size.QuadPart) >= min_size) {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if(mapping) {
+                data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+        if(!data) return nullptr;
+        size = static_cast<std::size_t>(file_size.QuadPart);
+        return static_cast<std::byte*>(data);
+    }
+
+    void unmap_file(std::byte* data, std::size_t) {
+        UnmapViewOfFile(data);
+    }
+
+    // sequential access was already hinted when the file was opened
+    void advise_sequential(std::byte*, std::size_t) {}
+
+    std::uintptr_t page_size() {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+    }
+
+    // unlocking pages that are not locked takes them out of the working set
+    void drop_pages(void* data, std::size_t size) {
+        VirtualUnlock(data, size);
+    }
+#else
+    std::byte* map_file(const std::string& path, std::size_t min_size, std::size_t& size) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0) return nullptr;
+        struct stat status {};
+        void* data = MAP_FAILED;
+        if(fstat(fd, &status) == 0 && status.st_size >= static_cast<off_t>(min_size)) {
+            data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if(data == MAP_FAILED) return nullptr;
+        size = status.st_size;
+        return static_cast<std::byte*>(data);
+    }
+
+    void unmap_file(std::byte* data, std::size_t size) {
+        munmap(data, size);
+    }
+
+    void advise_sequential(std::byte* data, std::size_t size) {
+        madvise(data, size, MADV_SEQUENTIAL);
+    }
+
+    std::uintptr_t page_size() {
+        return static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    void drop_pages(void* data, std::size_t size) {
+        madvise(data, size, MADV_DONTNEED);
+    }
+#endif
+
+    std::uint64_t align(std::uint64_t value) {
+        return (value + chunk_alignment - 1) / chunk_alignment * chunk_alignment;
+    }
+
+    // appends chunks of whole elements covering size bytes, the first one at file offset end
+    void split(std::vector<gl::mesh_chunk>& chunks, std::uint32_t kind, std::uint64_t size, std::uint64_t element_size,
+               std::size_t chunk_size, std::uint64_t& end) {
+        auto step = std::max<std::uint64_t>(chunk_size / element_size, 1) * element_size;
+        for(std::uint64_t offset = 0; offset < size; offset += step) {
+            auto bytes = std::min(step, size - offset);
+            chunks.push_back(gl::mesh_chunk { kind, 0, end, bytes, offset });
+            end = align(end + bytes);
+        }
+    }
+}
+
+bool gl::write_mesh_file(const std::string& path, const mesh_description& description,
+                         const void* vertices, const void* indices, std::size_t chunk_size) {
+    if(description.vertex_stride == 0) return false;
+    auto index_bytes = description.index_count * index_size(description.index_type);
+    if(description.index_count != 0 && index_bytes == 0) return false;
+
+    file_header header {};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = mesh_file::version;
+    header.vertex_stride = description.vertex_stride;
+    header.index_type = description.index_type;
+    header.vertex_count = description.vertex_count;
+    header.index_count = description.index_count;
+    header.attribute_count = static_cast<std::uint32_t>(description.attributes.size());
+
+    std::vector<mesh_chunk> chunks;
+    std::uint64_t end = 0;
+    split(chunks, mesh_chunk::vertices, description.vertex_count * description.vertex_stride, description.vertex_stride, chunk_size, end);
+    split(chunks, mesh_chunk::indices, index_bytes, index_size(description.index_type), chunk_size, end);
+    header.chunk_count = static_cast<std::uint32_t>(chunks.size());
+    // the data follows the tables, which are only sized now
+    auto data_begin = align(sizeof(file_header) + sizeof(mesh_attribute) * description.attributes.size() + sizeof(mesh_chunk) * chunks.size());
+    for(auto& c : chunks) c.file_offset += data_begin;
+
+    std::ofstream fout(path, std::ios::binary | std::ios::trunc);
+    if(!fout) return false;
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    fout.write(reinterpret_cast<const char*>(description.attributes.data()), sizeof(mesh_attribute) * description.attributes.size());
+    fout.write(reinterpret_cast<const char*>(chunks.data()), sizeof(mesh_chunk) * chunks.size());
+    for(const auto& c : chunks) {
+        // zero padding up to the chunk's offset
+        fout.seekp(static_cast<std::streamoff>(c.file_offset));
+        auto source = static_cast<const char*>(c.kind == mesh_chunk::vertices ? vertices : indices);
+        fout.write(source + c.buffer_offset, static_cast<std::streamsize>(c.size));
+    }
+    return static_cast<bool>(fout);
+}
+
+gl::mesh_file::mesh_file() : m_data(nullptr), m_size(0), m_description() {}
+
+gl::mesh_file::mesh_file(const std::string& path) : mesh_file() {
+    open(path);
+}
+
+gl::mesh_file::mesh_file(mesh_file&& obj) noexcept
+    : m_data(obj.m_data), m_size(obj.m_size), m_description(std::move(obj.m_description)), m_chunks(std::move(obj.m_chunks)) {
+    obj.m_data = nullptr;
+    obj.m_size = 0;
+}
+
+gl::mesh_file& gl::mesh_file::operator=(mesh_file&& obj) noexcept {
+    if(this != &obj) {
+        close();
+        m_data = obj.m_data;
+        m_size = obj.m_size;
+        m_description = std::move(obj.m_description);
+        m_chunks = std::move(obj.m_chunks);
+        obj.m_data = nullptr;
+        obj.m_size = 0;
+    }
+    return *this;
+}
+
+gl::mesh_file::~mesh_file() {
+    close();
+}
+
+bool gl::mesh_file::open(const std::string& path) {
+    close();
+    m_data = map_file(path, sizeof(file_header), m_size);
+    if(!m_data) return false;
+
+    file_header header;
+    std::memcpy(&header, m_data, sizeof(header));
+    auto table_end = sizeof(file_header) + sizeof(mesh_attribute) * std::uint64_t(header.attribute_count) +
+                     sizeof(mesh_chunk) * std::uint64_t(header.chunk_count);
+    if(std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version || header.vertex_stride == 0 ||
+       (header.index_count != 0 && index_size(header.index_type) == 0) || table_end > m_size) {
+        close();
+        return false;
+    }
+    m_description.vertex_stride = header.vertex_stride;
+    m_description.vertex_count = header.vertex_count;
+    m_description.index_type = header.index_type;
+    m_description.index_count = header.index_count;
+    m_description.attributes.resize(header.attribute_count);
+    std::memcpy(m_description.attributes.data(), m_data + sizeof(file_header), sizeof(mesh_attribute) * header.attribute_count);
+    m_chunks.resize(header.chunk_count);
+    std::memcpy(m_chunks.data(), m_data + sizeof(file_header) + sizeof(mesh_attribute) * header.attribute_count,
+                sizeof(mesh_chunk) * header.chunk_count);
+
+    for(const auto& c : m_chunks) {
+        auto buffer_size = c.kind == mesh_chunk::vertices ? vertex_bytes() : c.kind == mesh_chunk::indices ? index_bytes() : 0;
+        if(c.file_offset > m_size || c.size > m_size - c.file_offset || c.buffer_offset > buffer_size || c.size > buffer_size - c.buffer_offset) {
+            close();
+            return false;
+        }
+    }
+    // the data is read front to back, one chunk at a time
+    advise_sequential(m_data, m_size);
+    return true;
+}
+
+void gl::mesh_file::close() noexcept {
+    if(m_data) unmap_file(m_data, m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_description = mesh_description();
+    m_chunks.clear();
+}
+
+bool gl::mesh_file::is_open() const noexcept {
+    return m_data != nullptr;
+}
+
+const gl::mesh_description& gl::mesh_file::description() const noexcept {
+    return m_description;
+}
+
+const std::vector<gl::mesh_chunk>& gl::mesh_file::chunks() const noexcept {
+    return m_chunks;
+}
+
+std::size_t gl::mesh_file::vertex_bytes() const noexcept {
+    return m_description.vertex_count * m_description.vertex_stride;
+}
+
+std::size_t gl::mesh_file::index_bytes() const noexcept {
+    return m_description.index_count * index_size(m_description.index_type);
+}
+
+gl::span<const std::byte> gl::mesh_file::chunk_data(std::size_t chunk) const {
+    const auto& c = m_chunks[chunk];
+    return span<const std::byte>(m_data + c.file_offset, c.size);
+}
+
+void gl::mesh_file::upload(std::size_t chunk, GLuint buffer) const {
+    const auto& c = m_chunks[chunk];
+    if(c.size == 0) return;
+    auto data = m_data + c.file_offset;
+    // the range has never been drawn from, so it can be written without waiting for the GPU
+    constexpr GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+    void* mapped;
+    if(direct_state_access()) {
+        mapped = glMapNamedBufferRange(buffer, c.buffer_offset, c.size, access);
+    } else {
+        // the copy target leaves the vertex array's element buffer alone
+        current_state().bind_buffer(GL_COPY_WRITE_BUFFER, buffer);
+        mapped = glMapBufferRange(GL_COPY_WRITE_BUFFER, c.buffer_offset, c.size, access);
+    }
+    bool written = false;
+    if(mapped) {
+        std::memcpy(mapped, data, c.size);
+        written = direct_state_access() ? glUnmapNamedBuffer(buffer) : glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+    if(!written) {
+        if(direct_state_access()) {
+            glNamedBufferSubData(buffer, c.buffer_offset, c.size, data);
+        } else {
+            glBufferSubData(GL_COPY_WRITE_BUFFER, c.buffer_offset, c.size, data);
+        }
+    }
+    profile_upload(c.size);
+    release_pages(data, c.size);
+}
+
+void gl::mesh_file::release_pages(const std::byte* data, std::size_t size) const {
+    // only whole pages inside the chunk, a neighbour may still need the rest
+    auto page = page_size();
+    auto begin = (reinterpret_cast<std::uintptr_t>(data) + page - 1) / page * page;
+    auto end = (reinterpret_cast<std::uintptr_t>(data) + size) / page * page;
+    if(begin < end) drop_pages(reinterpret_cast<void*>(begin), end - begin);
+}
@@ -0,0 +1,178 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+#include "gl++/mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+float gl::average_cache_miss_ratio(span<const GLuint> indices, std::size_t vertex_count, std::size_t cache_size) {
+    if(indices.size() < 3) return 0.0f;
+    // a vertex is in the cache while fewer than cache_size misses happened after its own
+    std::vector<std::size_t> inserted(vertex_count, 0);
+    std::size_t misses = 0;
+    for(auto index : indices) {
+        if(inserted[index] == 0 || misses - inserted[index] + 1 > cache_size) {
+            misses++;
+            inserted[index] = misses;
+        }
+    }
+    return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
+
+namespace {
+    constexpr std::size_t forsyth_cache_size = 32;
+    constexpr GLuint forsyth_max_valence = 32;
+
+    // scores for every cache position and small valence, so the main loop does no pow/sqrt
+    struct score_table {
+        float cache[forsyth_cache_size + 1];
+        float valence[forsyth_max_valence + 1];
+        score_table() {
+            // outside the cache
+            cache[0] = 0.0f;
+            for(std::size_t i = 0; i < forsyth_cache_size; i++) {
+                // the last triangle's vertices get a fixed score so that strips do not zigzag back
+                cache[i + 1] = i < 3 ? 0.75f : std::pow(1.0f - static_cast<float>(i - 3) / (forsyth_cache_size - 3), 1.5f);
+            }
+            valence[0] = 0.0f;
+            for(GLuint i = 1; i <= forsyth_max_valence; i++) {
+                valence[i] = valence_score(i);
+            }
+        }
+        // vertices with few triangles left are finished first so they can leave the cache
+        static float valence_score(GLuint remaining) {
+            return 2.0f / std::sqrt(static_cast<float>(remaining));
+        }
+        float operator()(int cache_position, GLuint remaining) const {
+            if(remaining == 0) return -1.0f;
+            auto v = remaining <= forsyth_max_valence ? valence[remaining] : valence_score(remaining);
+            return cache[cache_position + 1] + v;
+        }
+    };
+}
+
+void gl::optimize_vertex_cache(span<GLuint> indices, std::size_t vertex_count) {
+    auto triangle_count = indices.size() / 3;
+    if(triangle_count == 0) return;
+    std::vector<GLuint> source(indices.begin(), indices.begin() + triangle_count * 3);
+
+    // triangles of every vertex. the first remaining[v] entries are the ones not emitted yet.
+    std::vector<GLuint> remaining(vertex_count, 0);
+    for(auto index : source) remaining[index]++;
+    std::vector<std::size_t> offsets(vertex_count + 1, 0);
+    for(std::size_t v = 0; v < vertex_count; v++) offsets[v + 1] = offsets[v] + remaining[v];
+    std::vector<GLuint> adjacency(source.size());
+    {
+        std::vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+        for(std::size_t t = 0; t < triangle_count; t++) {
+            for(int k = 0; k < 3; k++) adjacency[fill[source[t * 3 + k]]++] = static_cast<GLuint>(t);
+        }
+    }
+
+    static const score_table vertex_score;
+    std::vector<int> cache_position(vertex_count, -1);
+    std::vector<float> vertex_scores(vertex_count);
+    for(std::size_t v = 0; v < vertex_count; v++) vertex_scores[v] = vertex_score(-1, remaining[v]);
+    std::vector<float> triangle_scores(triangle_count);
+    std::vector<bool> emitted(triangle_count, false);
+    auto best = std::size_t(0);
+    for(std::size_t t = 0; t < triangle_count; t++) {
+        triangle_scores[t] = vertex_scores[source[t * 3]] + vertex_scores[source[t * 3 + 1]] + vertex_scores[source[t * 3 + 2]];
+        if(triangle_scores[t] > triangle_scores[best]) best = t;
+    }
+
+    std::vector<GLuint> cache, next_cache;
+    cache.reserve(forsyth_cache_size + 3);
+    next_cache.reserve(forsyth_cache_size + 3);
+    std::size_t cursor = 0;
+    for(std::size_t out = 0; out < triangle_count; out++) {
+        const auto* triangle = &source[best * 3];
+        std::copy(triangle, triangle + 3, indices.begin() + out * 3);
+        emitted[best] = true;
+        for(int k = 0; k < 3; k++) {
+            auto v = triangle[k];
+            auto first = adjacency.begin() + offsets[v];
+            auto last = first + remaining[v];
+            std::iter_swap(std::find(first, last, static_cast<GLuint>(best)), last - 1);
+            remaining[v]--;
+        }
+
+        // the triangle's vertices move to the front, the cache grows by up to 3 before the overflow is dropped
+        next_cache.assign(triangle, triangle + 3);
+        for(auto v : cache) {
+            if(v != triangle[0] && v != triangle[1] && v != triangle[2]) next_cache.push_back(v);
+        }
+        std::swap(cache, next_cache);
+        for(std::size_t i = 0; i < cache.size(); i++) {
+            auto v = cache[i];
+            cache_position[v] = i < forsyth_cache_size ? static_cast<int>(i) : -1;
+            vertex_scores[v] = vertex_score(cache_position[v], remaining[v]);
+        }
+
+        // only triangles touching the cache changed score
+        float best_score = -1.0f;
+        for(auto v : cache) {
+            for(std::size_t i = offsets[v]; i < offsets[v] + remaining[v]; i++) {
+                auto t = adjacency[i];
+                triangle_scores[t] = vertex_scores[source[t * 3]] + vertex_scores[source[t * 3 + 1]] + vertex_scores[source[t * 3 + 2]];
+                if(triangle_scores[t] > best_score) {
+                    best_score = triangle_scores[t];
+                    best = t;
+                }
+            }
+        }
+        if(cache.size() > forsyth_cache_size) cache.resize(forsyth_cache_size);
+        if(best_score < 0.0f) {
+            // nothing left around the cache, continue with the next triangle in the input order
+            while(cursor < triangle_count && emitted[cursor]) cursor++;
+            best = cursor;
+        }
+    }
+}
+
+std::size_t gl::optimize_vertex_fetch_remap(span<GLuint> remap, span<GLuint> indices) {
+    std::fill(remap.begin(), remap.end(), ~0u);
+    GLuint next = 0;
+    for(auto& index : indices) {
+        if(remap[index] == ~0u) remap[index] = next++;
+        index = remap[index];
+    }
+    return next;
+}
+
+namespace {
+    // FNV-1a
+    std::uint64_t hash_bytes(const unsigned char* data, std::size_t size) {
+        std::uint64_t hash = 14695981039346656037ull;
+        for(std::size_t i = 0; i < size; i++) {
+            hash = (hash ^ data[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
+std::size_t gl::generate_vertex_remap(span<GLuint> remap, const void* vertices, std::size_t vertex_count, std::size_t vertex_size) {
+    auto bytes = static_cast<const unsigned char*>(vertices);
+    // open addressing over vertex indices, at most half full
+    std::size_t capacity = 1;
+    while(capacity < vertex_count * 2) capacity <<= 1;
+    std::vector<GLuint> table(capacity, ~0u);
+    std::size_t unique = 0;
+    for(std::size_t i = 0; i < vertex_count; i++) {
+        auto vertex = bytes + i * vertex_size;
+        auto slot = hash_bytes(vertex, vertex_size) & (capacity - 1);
+        while(table[slot] != ~0u && std::memcmp(bytes + table[slot] * vertex_size, vertex, vertex_size) != 0) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        if(table[slot] == ~0u) {
+            table[slot] = static_cast<GLuint>(i);
+            remap[i] = static_cast<GLuint>(unique++);
+        } else {
+            remap[i] = remap[table[slot]];
+        }
+    }
+    return unique;
+}
@@ -0,0 +1,261 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+#include "gl++/packed_encode.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define GLPLUSPLUS_SSE2
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GLPLUSPLUS_F16C_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace {
+    // NaN goes to lo, like _mm_max_ps(x, lo)
+    float clamp(float x, float lo, float hi) {
+        return x > lo ? (x < hi ? x : hi) : lo;
+    }
+
+    template <class Integer>
+    Integer quantize(float x, float lo, float hi, float scale) {
+        return static_cast<Integer>(std::nearbyint(clamp(x, lo, hi) * scale));
+    }
+
+    // round to nearest even, overflow goes to infinity
+    std::uint16_t float_to_half(float value) {
+        std::uint32_t f;
+        std::memcpy(&f, &value, sizeof(f));
+        std::uint32_t sign = f & 0x80000000u;
+        f ^= sign;
+        std::uint16_t h;
+        if(f >= 0x47800000u) {
+            h = f > 0x7f800000u ? 0x7e00 : 0x7c00;
+        } else if(f < 0x38800000u) {
+            // half subnormals, the float addition does the rounding
+            float magnitude;
+            std::memcpy(&magnitude, &f, sizeof(f));
+            magnitude += 0.5f;
+            std::memcpy(&f, &magnitude, sizeof(f));
+            h = static_cast<std::uint16_t>(f - 0x3f000000u);
+        } else {
+            std::uint32_t odd = (f >> 13) & 1;
+            f += 0xc8000fffu + odd;
+            h = static_cast<std::uint16_t>(f >> 13);
+        }
+        return static_cast<std::uint16_t>(h | (sign >> 16));
+    }
+
+    void encode_half_scalar(const float* in, gl::half* out, std::size_t n) {
+        for(std::size_t i = 0; i < n; i++) {
+            out[i].bits = float_to_half(in[i]);
+        }
+    }
+
+#ifdef GLPLUSPLUS_F16C_DISPATCH
+    __attribute__((target("avx,f16c")))
+    void encode_half_f16c(const float* in, gl::half* out, std::size_t n) {
+        std::size_t i = 0;
+        for(; i + 8 <= n; i += 8) {
+            auto h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+        }
+        encode_half_scalar(in + i, out + i, n - i);
+    }
+
+    bool has_f16c() {
+        static const bool supported = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+        return supported;
+    }
+#endif
+
+#ifdef GLPLUSPLUS_SSE2
+    // four rounded int32 lanes of clamp(x, lo, hi) * scale
+    __m128i quantize4(const float* in, __m128 lo, __m128 hi, __m128 scale) {
+        auto x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in), lo), hi);
+        return _mm_cvtps_epi32(_mm_mul_ps(x, scale));
+    }
+#endif
+}
+
+void gl::encode(span<const float> in, span<half> out) {
+    assert(in.size() == out.size());
+#ifdef GLPLUSPLUS_F16C_DISPATCH
+    if(has_f16c()) {
+        encode_half_f16c(in.data(), out.data(), in.size());
+        return;
+    }
+#endif
+    encode_half_scalar(in.data(), out.data(), in.size());
+}
+
+void gl::encode(span<const float> in, span<snorm8> out) {
+    assert(in.size() == out.size());
+    std::size_t i = 0;
+#ifdef GLPLUSPLUS_SSE2
+    auto lo = _mm_set1_ps(-1.0f), hi = _mm_set1_ps(1.0f), scale = _mm_set1_ps(127.0f);
+    for(; i + 16 <= in.size(); i += 16) {
+        auto a = _mm_packs_epi32(quantize4(in.data() + i, lo, hi, scale), quantize4(in.data() + i + 4, lo, hi, scale));
+        auto b = _mm_packs_epi32(quantize4(in.data() + i + 8, lo, hi, scale), quantize4(in.data() + i + 12, lo, hi, scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out.data() + i), _mm_packs_epi16(a, b));
+    }
+#endif
+    for(; i < in.size(); i++) {
+        out[i].value = quantize<GLbyte>(in[i], -1.0f, 1.0f, 127.0f);
+    }
+}
+
+void gl::encode(span<const float> in, span<unorm8> out) {
+    assert(in.size() == out.size());
+    std::size_t i = 0;
+#ifdef GLPLUSPLUS_SSE2
+    auto lo = _mm_setzero_ps(), hi = _mm_set1_ps(1.0f), scale = _mm_set1_ps(255.0f);
+    for(; i + 16 <= in.size(); i += 16) {
+        auto a = _mm_packs_epi32(quantize4(in.data() + i, lo, hi, scale), quantize4(in.data() + i + 4, lo, hi, scale));
+        auto b = _mm_packs_epi32(quantize4(in.data() + i + 8, lo, hi, scale), quantize4(in.data() + i + 12, lo, hi, scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out.data() + i), _mm_packus_epi16(a, b));
+    }
+#endif
+    for(; i < in.size(); i++) {
+        out[i].value = quantize<GLubyte>(in[i], 0.0f, 1.0f, 255.0f);
+    }
+}
+
+void gl::encode(span<const float> in, span<snorm16> out) {
+    assert(in.size() == out.size());
+    std::size_t i = 0;
+#ifdef GLPLUSPLUS_SSE2
+    auto lo = _mm_set1_ps(-1.0f), hi = _mm_set1_ps(1.0f), scale = _mm_set1_ps(32767.0f);
+    for(; i + 8 <= in.size(); i += 8) {
+        auto a = _mm_packs_epi32(quantize4(in.data() + i, lo, hi, scale), quantize4(in.data() + i + 4, lo, hi, scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out.data() + i), a);
+    }
+#endif
+    for(; i < in.size(); i++) {
+        out[i].value = quantize<GLshort>(in[i], -1.0f, 1.0f, 32767.0f);
+    }
+}
+
+void gl::encode(span<const float> in, span<unorm16> out) {
+    assert(in.size() == out.size());
+    std::size_t i = 0;
+#ifdef GLPLUSPLUS_SSE2
+    auto lo = _mm_setzero_ps(), hi = _mm_set1_ps(1.0f), scale = _mm_set1_ps(65535.0f);
+    // SSE2 only has a signed 32 -> 16 bit pack, so the values are biased into its range and back
+    auto bias = _mm_set1_epi32(32768);
+    auto flip = _mm_set1_epi16(static_cast<short>(0x8000));
+    for(; i + 8 <= in.size(); i += 8) {
+        auto a = _mm_sub_epi32(quantize4(in.data() + i, lo, hi, scale), bias);
+        auto b = _mm_sub_epi32(quantize4(in.data() + i + 4, lo, hi, scale), bias);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out.data() + i), _mm_xor_si128(_mm_packs_epi32(a, b), flip));
+    }
+#endif
+    for(; i < in.size(); i++) {
+        out[i].value = quantize<GLushort>(in[i], 0.0f, 1.0f, 65535.0f);
+    }
+}
+
+namespace {
+    template <class Packed>
+    void encode_2_10_10_10(gl::span<const glm::vec4> in, gl::span<Packed> out, float lo, float xyz_scale, float w_scale) {
+        assert(in.size() == out.size());
+        std::size_t i = 0;
+#ifdef GLPLUSPLUS_SSE2
+        auto lo4 = _mm_set1_ps(lo), hi4 = _mm_set1_ps(1.0f);
+        auto xyz4 = _mm_set1_ps(xyz_scale), w4 = _mm_set1_ps(w_scale);
+        auto mask10 = _mm_set1_epi32(0x3ff), mask2 = _mm_set1_epi32(0x3);
+        for(; i + 4 <= in.size(); i += 4) {
+            // transpose four vectors so each register holds one component of all of them
+            auto x = _mm_loadu_ps(&in[i].x);
+            auto y = _mm_loadu_ps(&in[i + 1].x);
+            auto z = _mm_loadu_ps(&in[i + 2].x);
+            auto w = _mm_loadu_ps(&in[i + 3].x);
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+            auto q = [&](__m128 v, __m128 scale, __m128i mask) {
+                v = _mm_min_ps(_mm_max_ps(v, lo4), hi4);
+                return _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(v, scale)), mask);
+            };
+            auto packed = _mm_or_si128(
+                    _mm_or_si128(q(x, xyz4, mask10), _mm_slli_epi32(q(y, xyz4, mask10), 10)),
+                    _mm_or_si128(_mm_slli_epi32(q(z, xyz4, mask10), 20), _mm_slli_epi32(q(w, w4, mask2), 30)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out.data() + i), packed);
+        }
+#endif
+        for(; i < in.size(); i++) {
+            auto x = static_cast<GLuint>(quantize<GLint>(in[i].x, lo, 1.0f, xyz_scale)) & 0x3ff;
+            auto y = static_cast<GLuint>(quantize<GLint>(in[i].y, lo, 1.0f, xyz_scale)) & 0x3ff;
+            auto z = static_cast<GLuint>(quantize<GLint>(in[i].z, lo, 1.0f, xyz_scale)) & 0x3ff;
+            auto w = static_cast<GLuint>(quantize<GLint>(in[i].w, lo, 1.0f, w_scale)) & 0x3;
+            out[i].bits = x | y << 10 | z << 20 | w << 30;
+        }
+    }
+
+    // sign extends the low bits of a field
+    float signed_field(GLuint bits, int width) {
+        auto shift = 32 - width;
+        return static_cast<float>(static_cast<GLint>(bits << shift) >> shift);
+    }
+}
+
+void gl::encode(span<const glm::vec4> in, span<snorm_2_10_10_10> out) {
+    encode_2_10_10_10(in, out, -1.0f, 511.0f, 1.0f);
+}
+
+void gl::encode(span<const glm::vec4> in, span<unorm_2_10_10_10> out) {
+    encode_2_10_10_10(in, out, 0.0f, 1023.0f, 3.0f);
+}
+
+float gl::decode(half value) {
+    std::uint32_t sign = static_cast<std::uint32_t>(value.bits & 0x8000) << 16;
+    std::uint32_t exponent = (value.bits >> 10) & 0x1f;
+    std::uint32_t mantissa = value.bits & 0x3ff;
+    float magnitude;
+    if(exponent == 0) {
+        magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+    } else if(exponent == 0x1f) {
+        magnitude = mantissa ? NAN : INFINITY;
+    } else {
+        std::uint32_t f = (exponent + 112) << 23 | mantissa << 13;
+        std::memcpy(&magnitude, &f, sizeof(f));
+    }
+    return sign ? -magnitude : magnitude;
+}
+
+float gl::decode(snorm8 value) {
+    return std::max(value.value / 127.0f, -1.0f);
+}
+
+float gl::decode(unorm8 value) {
+    return value.value / 255.0f;
+}
+
+float gl::decode(snorm16 value) {
+    return std::max(value.value / 32767.0f, -1.0f);
+}
+
+float gl::decode(unorm16 value) {
+    return value.value / 65535.0f;
+}
+
+glm::vec4 gl::decode(snorm_2_10_10_10 value) {
+    return glm::vec4(
+            std::max(signed_field(value.bits, 10) / 511.0f, -1.0f),
+            std::max(signed_field(value.bits >> 10, 10) / 511.0f, -1.0f),
+            std::max(signed_field(value.bits >> 20, 10) / 511.0f, -1.0f),
+            std::max(signed_field(value.bits >> 30, 2), -1.0f));
+}
+
+glm::vec4 gl::decode(unorm_2_10_10_10 value) {
+    return glm::vec4(
+            (value.bits & 0x3ff) / 1023.0f,
+            (value.bits >> 10 & 0x3ff) / 1023.0f,
+            (value.bits >> 20 & 0x3ff) / 1023.0f,
+            (value.bits >> 30) / 3.0f);
+}
@@ -0,0 +1,143 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+#include "gl++/profiler.h"
+
+#ifdef GLPLUSPLUS_PROFILE
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+namespace {
+    void write_json_string(std::ostream& stream, const char* value) {
+        stream << '"';
+        for(; *value; value++) {
+            if(*value == '"' || *value == '\\') stream << '\\';
+            if(static_cast<unsigned char>(*value) >= 0x20) stream << *value;
+        }
+        stream << '"';
+    }
+}
+
+gl::profiler::profiler(std::uint64_t latency) noexcept : m_latency(latency), m_frame(0), m_depth(0), m_first_zone(0), m_counters() {}
+
+std::size_t gl::profiler::begin_zone(const char* name) {
+    pending_zone zone { profile_zone_record { name, m_frame, m_depth++, 0, 0 }, { acquire_query(), acquire_query() }, false };
+    glQueryCounter(zone.queries[0], GL_TIMESTAMP);
+    m_pending.push_back(zone);
+    return m_first_zone + m_pending.size() - 1;
+}
+
+void gl::profiler::end_zone(std::size_t zone) {
+    auto& pending = m_pending[zone - m_first_zone];
+    glQueryCounter(pending.queries[1], GL_TIMESTAMP);
+    pending.closed = true;
+    m_depth--;
+}
+
+void gl::profiler::end_frame() {
+    m_frame++;
+    // zones complete in the order they were issued, so stop at the first one not yet available
+    while(!m_pending.empty()) {
+        auto& zone = m_pending.front();
+        if(!zone.closed || zone.record.frame + m_latency > m_frame) break;
+        GLint available;
+        glGetQueryObjectiv(zone.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if(available == GL_FALSE) break;
+        GLuint64 begin, end;
+        glGetQueryObjectui64v(zone.queries[0], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(zone.queries[1], GL_QUERY_RESULT, &end);
+        zone.record.begin = begin;
+        zone.record.end = end;
+        m_zones.push_back(zone.record);
+        m_queries.push_back(zone.queries[0]);
+        m_queries.push_back(zone.queries[1]);
+        m_pending.pop_front();
+        m_first_zone++;
+    }
+}
+
+std::uint64_t gl::profiler::frame() const noexcept {
+    return m_frame;
+}
+
+const std::vector<gl::profile_zone_record>& gl::profiler::zones() const noexcept {
+    return m_zones;
+}
+
+gl::profile_counters& gl::profiler::counters() noexcept {
+    return m_counters;
+}
+
+const gl::profile_counters& gl::profiler::counters() const noexcept {
+    return m_counters;
+}
+
+void gl::profiler::write_chrome_trace(std::ostream& stream) const {
+    auto origin = std::numeric_limits<std::uint64_t>::max();
+    for(const auto& zone : m_zones) {
+        origin = std::min(origin, zone.begin);
+    }
+    stream << "{\"traceEvents\":[";
+    bool first = true;
+    for(const auto& zone : m_zones) {
+        if(!first) stream << ',';
+        first = false;
+        stream << "{\"name\":";
+        write_json_string(stream, zone.name);
+        stream << ",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+               << ",\"ts\":" << (zone.begin - origin) / 1000.0
+               << ",\"dur\":" << (zone.end - zone.begin) / 1000.0
+               << ",\"args\":{\"frame\":" << zone.frame << ",\"depth\":" << zone.depth << "}}";
+    }
+    if(!first) stream << ',';
+    stream << "{\"name\":\"gl++\",\"ph\":\"C\",\"pid\":0,\"tid\":0,\"ts\":0,\"args\":{"
+           << "\"uploaded_bytes\":" << m_counters.uploaded_bytes
+           << ",\"read_bytes\":" << m_counters.read_bytes
+           << ",\"program_binds\":" << m_counters.program_binds
+           << ",\"shader_compiles\":" << m_counters.shader_compiles
+           << ",\"program_links\":" << m_counters.program_links << "}}";
+    stream << "],\"displayTimeUnit\":\"ns\"}";
+}
+
+bool gl::profiler::write_chrome_trace(const std::string& path) const {
+    std::ofstream stream(path);
+    if(!stream) return false;
+    write_chrome_trace(stream);
+    return static_cast<bool>(stream);
+}
+
+void gl::profiler::reset() {
+    m_zones.clear();
+    m_counters = profile_counters();
+}
+
+void gl::profiler::release() {
+    for(auto& zone : m_pending) {
+        glDeleteQueries(2, zone.queries);
+    }
+    m_first_zone += m_pending.size();
+    m_pending.clear();
+    glDeleteQueries(m_queries.size(), m_queries.data());
+    m_queries.clear();
+    m_depth = 0;
+}
+
+GLuint gl::profiler::acquire_query() {
+    if(m_queries.empty()) {
+        GLuint query;
+        glGenQueries(1, &query);
+        return query;
+    }
+    auto query = m_queries.back();
+    m_queries.pop_back();
+    return query;
+}
+
+gl::profiler& gl::current_profiler() {
+    thread_local profiler instance;
+    return instance;
+}
+
+#endif
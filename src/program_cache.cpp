@@ -0,0 +1,128 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+#include "gl++/program_cache.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace {
+    constexpr std::uint64_t fnv_offset_basis = 14695981039346656037ull;
+    constexpr std::uint64_t fnv_prime = 1099511628211ull;
+
+    std::uint64_t fnv1a(std::uint64_t hash, const void* data, std::size_t size) {
+        auto bytes = static_cast<const unsigned char*>(data);
+        for(std::size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= fnv_prime;
+        }
+        return hash;
+    }
+
+    std::uint64_t fnv1a(std::uint64_t hash, const std::string& str) {
+        std::uint64_t size = str.size();
+        hash = fnv1a(hash, &size, sizeof(size));
+        return fnv1a(hash, str.data(), str.size());
+    }
+
+    std::string gl_string(GLenum name) {
+        auto str = reinterpret_cast<const char*>(glGetString(name));
+        return str ? str : "";
+    }
+}
+
+gl::program_cache::program_cache(std::string directory) : m_directory(std::move(directory)), m_hits(0), m_misses(0), m_rejected(0) {
+
+}
+
+bool gl::program_cache::build(shader_program& program, const std::vector<shader_source>& sources) {
+    if(!program.enabled()) return false;
+    auto file = path(sources);
+    if(load(program, file)) {
+        m_hits++;
+        return true;
+    }
+    m_misses++;
+
+    for(const auto& [source, type] : sources) {
+        if(!program.add_shader(source, type)) return false;
+    }
+    glProgramParameteri(program.handle(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    if(!program.link()) return false;
+    store(program, file);
+    return true;
+}
+
+const std::string& gl::program_cache::directory() const noexcept {
+    return m_directory;
+}
+
+std::size_t gl::program_cache::hits() const noexcept {
+    return m_hits;
+}
+
+std::size_t gl::program_cache::misses() const noexcept {
+    return m_misses;
+}
+
+std::size_t gl::program_cache::rejected() const noexcept {
+    return m_rejected;
+}
+
+void gl::program_cache::reset_statistics() noexcept {
+    m_hits = 0;
+    m_misses = 0;
+    m_rejected = 0;
+}
+
+std::string gl::program_cache::path(const std::vector<shader_source>& sources) const {
+    auto hash = fnv_offset_basis;
+    hash = fnv1a(hash, gl_string(GL_VENDOR));
+    hash = fnv1a(hash, gl_string(GL_RENDERER));
+    hash = fnv1a(hash, gl_string(GL_VERSION));
+    for(const auto& [source, type] : sources) {
+        hash = fnv1a(hash, &type, sizeof(type));
+        hash = fnv1a(hash, source);
+    }
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+    return (std::filesystem::path(m_directory) / (std::string(name) + ".bin")).string();
+}
+
+bool gl::program_cache::load(shader_program& program, const std::string& path) {
+    std::ifstream fin(path, std::ios::binary);
+    if(!fin.good()) return false;
+    GLenum format;
+    if(!fin.read(reinterpret_cast<char*>(&format), sizeof(format))) return false;
+    std::string binary { std::istreambuf_iterator<char>{fin}, std::istreambuf_iterator<char>{} };
+    if(binary.empty()) return false;
+
+    glProgramBinary(program.handle(), format, binary.data(), binary.size());
+    GLint status;
+    glGetProgramiv(program.handle(), GL_LINK_STATUS, &status);
+    if(status == GL_FALSE) {
+        m_rejected++;
+        return false;
+    }
+    program.reflect();
+    return true;
+}
+
+void gl::program_cache::store(const shader_program& program, const std::string& path) const {
+    GLint length = 0;
+    glGetProgramiv(program.handle(), GL_PROGRAM_BINARY_LENGTH, &length);
+    if(length <= 0) return;
+    std::string binary(length, 0);
+    GLenum format;
+    glGetProgramBinary(program.handle(), length, &length, &format, binary.data());
+    binary.resize(length);
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    std::ofstream fout(path, std::ios::binary | std::ios::trunc);
+    if(!fout.good()) return;
+    fout.write(reinterpret_cast<const char*>(&format), sizeof(format));
+    fout.write(binary.data(), binary.size());
+}
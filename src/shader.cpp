@@ -3,7 +3,76 @@
 //
 #include "gl++/shader.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <tuple>
+
+#include "gl++/deletion_queue.h"
+#include "gl++/profiler.h"
+#include "gl++/state_cache.h"
+
+namespace {
+    bool resource_less(const gl::program_resource& lhs, const gl::program_resource& rhs) {
+        return std::make_tuple(lhs.program_interface, lhs.hash.value()) < std::make_tuple(rhs.program_interface, rhs.hash.value());
+    }
+
+    using resource_key = std::tuple<GLenum, std::uint32_t>;
+
+    struct resource_key_less {
+        bool operator()(const gl::program_resource& lhs, const resource_key& rhs) const noexcept {
+            return std::make_tuple(lhs.program_interface, lhs.hash.value()) < rhs;
+        }
+        bool operator()(const resource_key& lhs, const gl::program_resource& rhs) const noexcept {
+            return lhs < std::make_tuple(rhs.program_interface, rhs.hash.value());
+        }
+    };
+
+    // a trailing "[0]" is ignored like name_hash does
+    std::string_view strip_array(std::string_view name) noexcept {
+        if(name.size() > 3 && name.substr(name.size() - 3) == "[0]") return name.substr(0, name.size() - 3);
+        return name;
+    }
+
+    void reflect_interface(GLuint program, GLenum program_interface, std::vector<gl::program_resource>& resources) {
+        GLint count = 0;
+        glGetProgramInterfaceiv(program, program_interface, GL_ACTIVE_RESOURCES, &count);
+        bool is_block = program_interface == GL_UNIFORM_BLOCK || program_interface == GL_SHADER_STORAGE_BLOCK;
+        bool has_location = program_interface == GL_UNIFORM || program_interface == GL_PROGRAM_INPUT;
+        bool has_offset = program_interface == GL_UNIFORM || program_interface == GL_BUFFER_VARIABLE;
+        for(GLint i = 0; i < count; i++) {
+            GLint name_length = 0;
+            GLenum name_length_prop = GL_NAME_LENGTH;
+            glGetProgramResourceiv(program, program_interface, i, 1, &name_length_prop, 1, nullptr, &name_length);
+            std::string name(name_length, 0);
+            glGetProgramResourceName(program, program_interface, i, name_length, nullptr, name.data());
+            name.resize(name_length > 0 ? name_length - 1 : 0);
+
+            GLint values[6] = { -1, 0, 0, -1, -1, 0 };
+            if(is_block) {
+                GLenum props[] = { GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE };
+                glGetProgramResourceiv(program, program_interface, i, 2, props, 2, nullptr, values);
+                values[5] = values[1];
+                values[1] = 0;
+            } else {
+                GLenum props[] = { GL_TYPE, GL_ARRAY_SIZE };
+                glGetProgramResourceiv(program, program_interface, i, 2, props, 2, nullptr, values + 1);
+                if(has_location) {
+                    GLenum prop = GL_LOCATION;
+                    glGetProgramResourceiv(program, program_interface, i, 1, &prop, 1, nullptr, values);
+                }
+                if(has_offset) {
+                    GLenum offset_props[] = { GL_BLOCK_INDEX, GL_OFFSET };
+                    glGetProgramResourceiv(program, program_interface, i, 2, offset_props, 2, nullptr, values + 3);
+                }
+            }
+            gl::name_hash hash(name);
+            resources.push_back(gl::program_resource {
+                std::move(name), hash, program_interface, static_cast<GLuint>(i),
+                values[0], static_cast<GLenum>(values[1]), values[2], values[3], values[4], values[5] });
+        }
+    }
+}
 
 gl::shader_program::shader_program() {
     m_handle = glCreateProgram();
@@ -21,19 +90,16 @@ GLuint gl::shader_program::handle() const noexcept {
     return m_handle;
 }
 
-gl::shader_program::shader_program(shader_program &&obj) noexcept {
-    if(this != &obj) {
-        reset();
-        m_handle = obj.m_handle;
-        obj.m_handle = 0;
-    }
+gl::shader_program::shader_program(shader_program &&obj) noexcept : m_handle(obj.m_handle), m_resources(std::move(obj.m_resources)) {
+    obj.m_handle = 0;
 }
 
 void gl::shader_program::reset() {
     if(enabled()) {
-        glDeleteProgram(handle());
+        delete_program(handle());
         m_handle = 0;
     }
+    m_resources.clear();
 }
 
 bool gl::shader_program::add_shader(const std::string &src, GLenum type) {
@@ -43,6 +109,7 @@ bool gl::shader_program::add_shader(const std::string &src, GLenum type) {
     GLint length = src.size();
     glShaderSource(shader, 1, &source, &length);
     glCompileShader(shader);
+    profile_shader_compile();
 
     GLint status;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
@@ -60,13 +127,24 @@ bool gl::shader_program::add_shader(const std::string &src, GLenum type) {
     return true;
 }
 
-bool gl::shader_program::add_shader_binary(const std::string &bin, GLenum type) {
+bool gl::shader_program::add_shader_binary(const std::string &bin, GLenum type, const std::string& entry_point,
+                                           span<const specialization_constant> constants) {
     if(!enabled()) return false;
+    // the core entry point is only loaded for 4.6 contexts
+    auto specialize = GLEW_VERSION_4_6 ? glSpecializeShader : GLEW_ARB_gl_spirv ? glSpecializeShaderARB : nullptr;
+    if(!specialize) return false;
     GLuint shader = glCreateShader(type);
     auto source = bin.data();
     GLint length = bin.size();
     glShaderBinary(1, &shader, GL_SHADER_BINARY_FORMAT_SPIR_V, source, length);
-    glCompileShader(shader);
+    // SPIR-V modules are specialized instead of compiled
+    std::vector<GLuint> indices, values;
+    for(const auto& constant : constants) {
+        indices.push_back(constant.id);
+        values.push_back(constant.value);
+    }
+    specialize(shader, entry_point.c_str(), static_cast<GLuint>(indices.size()), indices.data(), values.data());
+    profile_shader_compile();
 
     GLint status;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
@@ -84,9 +162,18 @@ bool gl::shader_program::add_shader_binary(const std::string &bin, GLenum type)
     return true;
 }
 
+bool gl::shader_program::transform_feedback_varyings(const std::vector<std::string>& varyings, GLenum buffer_mode) {
+    if(!enabled()) return false;
+    std::vector<const GLchar*> names;
+    for(const auto& varying : varyings) names.push_back(varying.c_str());
+    glTransformFeedbackVaryings(handle(), static_cast<GLsizei>(names.size()), names.data(), buffer_mode);
+    return true;
+}
+
 bool gl::shader_program::link() {
     if(!enabled()) return false;
     glLinkProgram(handle());
+    profile_program_link();
     GLint status;
     glGetProgramiv(handle(), GL_LINK_STATUS, &status);
     if(status == GL_FALSE) {
@@ -98,14 +185,86 @@ bool gl::shader_program::link() {
         return false;
     }
 
+    reflect();
     return true;
 }
 
+void gl::shader_program::reflect() {
+    m_resources.clear();
+    if(!enabled()) return;
+    for(auto program_interface : { GL_UNIFORM, GL_PROGRAM_INPUT, GL_UNIFORM_BLOCK, GL_SHADER_STORAGE_BLOCK, GL_BUFFER_VARIABLE }) {
+        reflect_interface(handle(), program_interface, m_resources);
+    }
+    std::sort(m_resources.begin(), m_resources.end(), resource_less);
+    // lookups by hash alone cannot tell these apart, the ones by name still can
+    for(std::size_t i = 1; i < m_resources.size(); i++) {
+        const auto& prev = m_resources[i - 1];
+        const auto& cur = m_resources[i];
+        if(prev.program_interface == cur.program_interface && prev.hash == cur.hash) {
+            std::cerr << "gl++: resource names " << prev.name << " and " << cur.name << " have the same hash" << std::endl;
+        }
+    }
+}
+
+const std::vector<gl::program_resource>& gl::shader_program::resources() const noexcept {
+    return m_resources;
+}
+
+const gl::program_resource* gl::shader_program::find_resource(GLenum program_interface, name_hash name) const noexcept {
+    auto it = std::lower_bound(m_resources.begin(), m_resources.end(), resource_key(program_interface, name.value()), resource_key_less());
+    if(it == m_resources.end() || it->program_interface != program_interface || it->hash != name) return nullptr;
+    return &*it;
+}
+
+const gl::program_resource* gl::shader_program::find_resource(GLenum program_interface, std::string_view name) const noexcept {
+    auto [first, last] = std::equal_range(m_resources.begin(), m_resources.end(),
+                                          resource_key(program_interface, name_hash(name).value()), resource_key_less());
+    // the hash only narrows the search, names that collide are told apart here
+    auto it = std::find_if(first, last, [name = strip_array(name)](const program_resource& r) { return strip_array(r.name) == name; });
+    return it == last ? nullptr : &*it;
+}
+
+GLint gl::shader_program::uniform_location(name_hash name) const noexcept {
+    auto resource = find_resource(GL_UNIFORM, name);
+    return resource ? resource->location : -1;
+}
+
+GLint gl::shader_program::uniform_location(std::string_view name) const noexcept {
+    auto resource = find_resource(GL_UNIFORM, name);
+    return resource ? resource->location : -1;
+}
+
+GLint gl::shader_program::attribute_location(name_hash name) const noexcept {
+    auto resource = find_resource(GL_PROGRAM_INPUT, name);
+    return resource ? resource->location : -1;
+}
+
+GLint gl::shader_program::attribute_location(std::string_view name) const noexcept {
+    auto resource = find_resource(GL_PROGRAM_INPUT, name);
+    return resource ? resource->location : -1;
+}
+
+const gl::program_resource* gl::shader_program::uniform_block(name_hash name) const noexcept {
+    return find_resource(GL_UNIFORM_BLOCK, name);
+}
+
+const gl::program_resource* gl::shader_program::uniform_block(std::string_view name) const noexcept {
+    return find_resource(GL_UNIFORM_BLOCK, name);
+}
+
+const gl::program_resource* gl::shader_program::storage_block(name_hash name) const noexcept {
+    return find_resource(GL_SHADER_STORAGE_BLOCK, name);
+}
+
+const gl::program_resource* gl::shader_program::storage_block(std::string_view name) const noexcept {
+    return find_resource(GL_SHADER_STORAGE_BLOCK, name);
+}
+
 void gl::shader_program::use() const {
-    glUseProgram(handle());
+    current_state().use_program(handle());
 }
 
 void gl::shader_program::unuse() const {
-    glUseProgram(0);
+    current_state().use_program(0);
 }
 
@@ -0,0 +1,141 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+#include "gl++/shader_batch.h"
+
+#include "gl++/profiler.h"
+
+gl::shader_batch::shader_batch() : m_pending(0), m_parallel(GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile) {
+    if(GLEW_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    } else if(GLEW_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+    }
+}
+
+gl::shader_batch::shader_batch(shader_batch&& obj) noexcept
+    : m_entries(std::move(obj.m_entries)), m_pending(obj.m_pending), m_parallel(obj.m_parallel) {
+    obj.m_entries.clear();
+    obj.m_pending = 0;
+}
+
+gl::shader_batch& gl::shader_batch::operator=(shader_batch&& obj) noexcept {
+    if(this != &obj) {
+        release();
+        m_entries = std::move(obj.m_entries);
+        m_pending = obj.m_pending;
+        m_parallel = obj.m_parallel;
+        obj.m_entries.clear();
+        obj.m_pending = 0;
+    }
+    return *this;
+}
+
+gl::shader_batch::~shader_batch() {
+    release();
+}
+
+std::size_t gl::shader_batch::add(shader_program& program, const std::vector<shader_source>& sources) {
+    entry e { &program, {}, program_status::pending, {} };
+    if(!program.enabled()) {
+        e.status = program_status::failed;
+        m_entries.push_back(std::move(e));
+        return m_entries.size() - 1;
+    }
+    for(const auto& [src, type] : sources) {
+        GLuint shader = glCreateShader(type);
+        auto source = src.data();
+        GLint length = src.size();
+        glShaderSource(shader, 1, &source, &length);
+        glCompileShader(shader);
+        profile_shader_compile();
+        glAttachShader(program.handle(), shader);
+        e.shaders.push_back(shader);
+    }
+    glLinkProgram(program.handle());
+    profile_program_link();
+    m_entries.push_back(std::move(e));
+    m_pending++;
+    return m_entries.size() - 1;
+}
+
+gl::program_status gl::shader_batch::status(std::size_t index) {
+    auto& e = m_entries.at(index);
+    if(e.status != program_status::pending) return e.status;
+    if(m_parallel) {
+        GLint completed;
+        glGetProgramiv(e.program->handle(), GL_COMPLETION_STATUS_KHR, &completed);
+        if(completed == GL_FALSE) return e.status;
+    }
+    complete(e);
+    return e.status;
+}
+
+bool gl::shader_batch::poll() {
+    for(std::size_t i = 0; i < m_entries.size() && m_pending != 0; i++) {
+        status(i);
+    }
+    return m_pending == 0;
+}
+
+void gl::shader_batch::wait() {
+    for(auto& e : m_entries) {
+        if(e.status == program_status::pending) complete(e);
+    }
+}
+
+const std::string& gl::shader_batch::log(std::size_t index) const {
+    return m_entries.at(index).log;
+}
+
+std::size_t gl::shader_batch::size() const noexcept {
+    return m_entries.size();
+}
+
+std::size_t gl::shader_batch::pending() const noexcept {
+    return m_pending;
+}
+
+bool gl::shader_batch::parallel() const noexcept {
+    return m_parallel;
+}
+
+void gl::shader_batch::complete(entry& e) {
+    GLint status;
+    glGetProgramiv(e.program->handle(), GL_LINK_STATUS, &status);
+    if(status == GL_FALSE) {
+        for(auto shader : e.shaders) {
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+            if(status == GL_FALSE) {
+                GLsizei size; glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &size);
+                std::string log(size, 0);
+                glGetShaderInfoLog(shader, log.length(), &size, log.data());
+                e.log += log.c_str();
+            }
+        }
+        GLsizei size; glGetProgramiv(e.program->handle(), GL_INFO_LOG_LENGTH, &size);
+        std::string log(size, 0);
+        glGetProgramInfoLog(e.program->handle(), log.length(), &size, log.data());
+        e.log += log.c_str();
+        e.status = program_status::failed;
+    } else {
+        e.status = program_status::ready;
+        e.program->reflect();
+    }
+    for(auto shader : e.shaders) {
+        glDetachShader(e.program->handle(), shader);
+        glDeleteShader(shader);
+    }
+    e.shaders.clear();
+    m_pending--;
+}
+
+void gl::shader_batch::release() noexcept {
+    for(auto& e : m_entries) {
+        for(auto shader : e.shaders) {
+            glDeleteShader(shader);
+        }
+    }
+    m_entries.clear();
+    m_pending = 0;
+}
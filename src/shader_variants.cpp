@@ -0,0 +1,92 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+#include "gl++/shader_variants.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+namespace {
+    constexpr std::uint32_t spirv_magic = 0x07230203;
+    constexpr std::uint32_t spirv_header_words = 5;
+    constexpr std::uint32_t op_decorate = 71;
+    constexpr std::uint32_t decoration_spec_id = 1;
+}
+
+std::vector<GLuint> gl::specialization_ids(const std::string& binary) {
+    std::vector<GLuint> ids;
+    if(binary.size() % 4 != 0 || binary.size() < spirv_header_words * 4) return ids;
+    std::vector<std::uint32_t> words(binary.size() / 4);
+    std::memcpy(words.data(), binary.data(), binary.size());
+    if(words[0] != spirv_magic) return ids;
+    // every instruction starts with its word count in the high half and its opcode in the low half
+    for(std::size_t i = spirv_header_words; i < words.size();) {
+        auto count = words[i] >> 16;
+        auto opcode = words[i] & 0xffff;
+        if(count == 0 || i + count > words.size()) break;
+        // OpDecorate target SpecId id
+        if(opcode == op_decorate && count == 4 && words[i + 2] == decoration_spec_id) ids.push_back(words[i + 3]);
+        i += count;
+    }
+    return ids;
+}
+
+gl::shader_variants::shader_variants(std::vector<spirv_stage> stages) : m_hits(0), m_misses(0) {
+    for(auto& s : stages) {
+        auto ids = specialization_ids(s.binary);
+        m_stages.push_back(stage { std::move(s), std::move(ids) });
+    }
+}
+
+gl::shader_program* gl::shader_variants::get(span<const specialization_constant> constants) {
+    std::vector<specialization_constant> key(constants.begin(), constants.end());
+    std::sort(key.begin(), key.end());
+    auto it = m_variants.find(key);
+    if(it != m_variants.end()) {
+        m_hits++;
+    } else {
+        m_misses++;
+        it = m_variants.emplace(std::move(key), shader_program()).first;
+        if(!build(it->second, it->first)) it->second.reset();
+    }
+    return it->second.enabled() ? &it->second : nullptr;
+}
+
+gl::shader_program* gl::shader_variants::get(std::initializer_list<specialization_constant> constants) {
+    return get(span<const specialization_constant>(constants.begin(), constants.size()));
+}
+
+std::size_t gl::shader_variants::size() const noexcept {
+    return m_variants.size();
+}
+
+std::size_t gl::shader_variants::hits() const noexcept {
+    return m_hits;
+}
+
+std::size_t gl::shader_variants::misses() const noexcept {
+    return m_misses;
+}
+
+void gl::shader_variants::reset_statistics() noexcept {
+    m_hits = 0;
+    m_misses = 0;
+}
+
+void gl::shader_variants::clear() {
+    m_variants.clear();
+}
+
+bool gl::shader_variants::build(shader_program& program, const std::vector<specialization_constant>& constants) const {
+    for(const auto& s : m_stages) {
+        // a constant the module does not declare would fail the specialization
+        std::vector<specialization_constant> used;
+        std::copy_if(constants.begin(), constants.end(), std::back_inserter(used), [&s](const specialization_constant& c) {
+            return std::find(s.ids.begin(), s.ids.end(), c.id) != s.ids.end();
+        });
+        if(!program.add_shader_binary(s.source.binary, s.source.type, s.source.entry_point, used)) return false;
+    }
+    return program.link();
+}
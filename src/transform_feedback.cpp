@@ -0,0 +1,123 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+#include "gl++/transform_feedback.h"
+
+#include "gl++/direct_state_access.h"
+#include "gl++/state_cache.h"
+
+gl::transform_feedback::transform_feedback() : m_handle(0), m_query(0), m_discard(false) {
+    if(direct_state_access()) {
+        glCreateTransformFeedbacks(1, &m_handle);
+        glCreateQueries(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, 1, &m_query);
+    } else {
+        glGenTransformFeedbacks(1, &m_handle);
+        glGenQueries(1, &m_query);
+    }
+}
+
+gl::transform_feedback::transform_feedback(transform_feedback&& obj) noexcept
+    : m_handle(obj.m_handle), m_query(obj.m_query), m_discard(obj.m_discard) {
+    obj.m_handle = 0;
+    obj.m_query = 0;
+}
+
+gl::transform_feedback& gl::transform_feedback::operator=(transform_feedback&& obj) noexcept {
+    if(this != &obj) {
+        glDeleteTransformFeedbacks(1, &m_handle);
+        glDeleteQueries(1, &m_query);
+        m_handle = obj.m_handle;
+        m_query = obj.m_query;
+        m_discard = obj.m_discard;
+        obj.m_handle = 0;
+        obj.m_query = 0;
+    }
+    return *this;
+}
+
+gl::transform_feedback::~transform_feedback() {
+    glDeleteTransformFeedbacks(1, &m_handle);
+    glDeleteQueries(1, &m_query);
+}
+
+GLuint gl::transform_feedback::handle() const noexcept {
+    return m_handle;
+}
+
+void gl::transform_feedback::capture(GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    if(direct_state_access()) {
+        if(size > 0) {
+            glTransformFeedbackBufferRange(m_handle, index, buffer, offset, size);
+        } else {
+            glTransformFeedbackBufferBase(m_handle, index, buffer);
+        }
+        return;
+    }
+    // the indexed bindings belong to the feedback object bound at the time, so another one may be set up already
+    GLint previous = 0;
+    glGetIntegerv(GL_TRANSFORM_FEEDBACK_BINDING, &previous);
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, m_handle);
+    if(size > 0) {
+        current_state().bind_buffer_range(GL_TRANSFORM_FEEDBACK_BUFFER, index, buffer, offset, size);
+    } else {
+        current_state().bind_buffer_base(GL_TRANSFORM_FEEDBACK_BUFFER, index, buffer);
+    }
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, previous);
+}
+
+void gl::transform_feedback::begin(GLenum primitive_mode, bool discard) {
+    m_discard = discard;
+    if(m_discard) glEnable(GL_RASTERIZER_DISCARD);
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, m_handle);
+    glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, m_query);
+    glBeginTransformFeedback(primitive_mode);
+}
+
+void gl::transform_feedback::end() {
+    glEndTransformFeedback();
+    glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
+    if(m_discard) glDisable(GL_RASTERIZER_DISCARD);
+    m_discard = false;
+}
+
+void gl::transform_feedback::pause() {
+    glPauseTransformFeedback();
+}
+
+void gl::transform_feedback::resume() {
+    glResumeTransformFeedback();
+}
+
+void gl::transform_feedback::draw(GLenum mode, GLsizei instance_count) const {
+    glDrawTransformFeedbackInstanced(mode, m_handle, instance_count);
+}
+
+bool gl::transform_feedback::result_available() const {
+    GLuint available = GL_FALSE;
+    glGetQueryObjectuiv(m_query, GL_QUERY_RESULT_AVAILABLE, &available);
+    return available == GL_TRUE;
+}
+
+GLuint gl::transform_feedback::primitives_written() const {
+    GLuint count = 0;
+    glGetQueryObjectuiv(m_query, GL_QUERY_RESULT, &count);
+    return count;
+}
+
+bool gl::transform_feedback::primitives_written(GLuint& count) const {
+    if(!result_available()) return false;
+    glGetQueryObjectuiv(m_query, GL_QUERY_RESULT_NO_WAIT, &count);
+    return true;
+}
+
+void gl::transform_feedback::primitives_written(GLuint buffer, GLintptr offset) const {
+    if(direct_state_access()) {
+        glGetQueryBufferObjectuiv(m_query, buffer, GL_QUERY_RESULT, offset);
+    } else {
+        // with a query buffer bound, the pointer argument is an offset into it
+        glBindBuffer(GL_QUERY_BUFFER, buffer);
+        glGetQueryObjectuiv(m_query, GL_QUERY_RESULT, reinterpret_cast<GLuint*>(offset));
+        glBindBuffer(GL_QUERY_BUFFER, 0);
+    }
+}
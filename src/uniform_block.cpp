@@ -0,0 +1,72 @@
+//
+// Created by asuka1975 on 2026/10/17.
+//
+#include "gl++/uniform_block.h"
+
+#include <cstring>
+
+#include "gl++/state_cache.h"
+
+bool gl::match_block_layout(const shader_program& program, GLenum block_interface, name_hash block,
+                            span<const name_hash> members, span<const std::size_t> offsets) {
+    auto block_resource = program.find_resource(block_interface, block);
+    if(!block_resource || members.size() != offsets.size()) return false;
+    // members of uniform blocks are reflected as uniforms, members of storage blocks as buffer variables
+    auto member_interface = block_interface == GL_UNIFORM_BLOCK ? GL_UNIFORM : GL_BUFFER_VARIABLE;
+    for(std::size_t i = 0; i < members.size(); i++) {
+        auto member = program.find_resource(member_interface, members[i]);
+        if(!member || member->block_index != static_cast<GLint>(block_resource->index)) return false;
+        if(member->offset < 0 || static_cast<std::size_t>(member->offset) != offsets[i]) return false;
+    }
+    return true;
+}
+
+gl::uniform_allocator::uniform_allocator(std::size_t frame_size)
+    : m_alignment(query_alignment()),
+      // every frame starts on an aligned offset too
+      m_buffer((frame_size + m_alignment - 1) / m_alignment * m_alignment), m_frame(), m_used(0) {}
+
+void gl::uniform_allocator::begin_frame() {
+    m_frame = m_buffer.map();
+    m_used = 0;
+}
+
+void gl::uniform_allocator::end_frame() {
+    m_buffer.fence();
+    m_frame = span<std::byte>();
+    m_used = 0;
+}
+
+std::optional<gl::uniform_range> gl::uniform_allocator::push(const void* data, std::size_t size) {
+    auto offset = (m_used + m_alignment - 1) / m_alignment * m_alignment;
+    if(offset + size > m_frame.size()) return std::nullopt;
+    std::memcpy(m_frame.data() + offset, data, size);
+    m_used = offset + size;
+    return uniform_range { m_buffer.handle(), static_cast<GLintptr>(m_buffer.offset() + offset), static_cast<GLsizeiptr>(size) };
+}
+
+void gl::uniform_allocator::bind(GLuint point, const uniform_range& range) {
+    current_state().bind_buffer_range(GL_UNIFORM_BUFFER, point, range.buffer, range.offset, range.size);
+}
+
+std::size_t gl::uniform_allocator::alignment() const noexcept {
+    return m_alignment;
+}
+
+std::size_t gl::uniform_allocator::frame_size() const noexcept {
+    return m_buffer.size();
+}
+
+std::size_t gl::uniform_allocator::used() const noexcept {
+    return m_used;
+}
+
+const gl::uniform_allocator::buffer_type& gl::uniform_allocator::buffer() const noexcept {
+    return m_buffer;
+}
+
+std::size_t gl::uniform_allocator::query_alignment() {
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    return alignment > 0 ? static_cast<std::size_t>(alignment) : 256;
+}
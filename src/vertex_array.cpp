@@ -3,13 +3,15 @@
 //
 #include "gl++/vertex_array.h"
 
+#include "gl++/deletion_queue.h"
+#include "gl++/state_cache.h"
 
-gl::vertex_array::bind_context::bind_context(std::reference_wrapper<const vertex_array> ref) : array(ref) {
+gl::vertex_array::bind_context::bind_context(std::reference_wrapper<const vertex_array> ref) : array(ref), previous(current_state().query_vertex_array()) {
     array.get().bind();
 }
 
 gl::vertex_array::bind_context::~bind_context() {
-    array.get().unbind();
+    current_state().bind_vertex_array(previous);
 }
 
 gl::vertex_array::bind_context::operator bool() const {
@@ -17,7 +19,11 @@ gl::vertex_array::bind_context::operator bool() const {
 }
 
 gl::vertex_array::vertex_array() {
-    glGenVertexArrays(1, &m_handle);
+    if(direct_state_access()) {
+        glCreateVertexArrays(1, &m_handle);
+    } else {
+        glGenVertexArrays(1, &m_handle);
+    }
 }
 
 gl::vertex_array::vertex_array(GLuint handle) : m_handle(handle) {
@@ -25,10 +31,8 @@ gl::vertex_array::vertex_array(GLuint handle) : m_handle(handle) {
 }
 
 gl::vertex_array::~vertex_array() {
-    if(m_handle) {
-        glDeleteVertexArrays(1, &m_handle);
-        m_handle = false;
-    }
+    delete_vertex_array(m_handle);
+    m_handle = 0;
 }
 
 GLuint gl::vertex_array::handle() const noexcept {
@@ -40,9 +44,45 @@ gl::vertex_array::bind_context gl::vertex_array::get_bind() const {
 }
 
 void gl::vertex_array::bind() const {
-    glBindVertexArray(m_handle);
+    current_state().bind_vertex_array(m_handle);
 }
 
 void gl::vertex_array::unbind() const {
-    glBindVertexArray(0);
+    current_state().bind_vertex_array(0);
+}
+
+void gl::vertex_array::bind_vertex_buffer(GLuint binding, GLuint buffer, GLintptr offset, GLsizei stride) const {
+    if(direct_state_access()) {
+        glVertexArrayVertexBuffer(m_handle, binding, buffer, offset, stride);
+    } else {
+        bind();
+        glBindVertexBuffer(binding, buffer, offset, stride);
+    }
+}
+
+void gl::vertex_array::attrib_binding(GLuint location, GLuint binding) const {
+    if(direct_state_access()) {
+        glVertexArrayAttribBinding(m_handle, location, binding);
+    } else {
+        bind();
+        glVertexAttribBinding(location, binding);
+    }
+}
+
+void gl::vertex_array::binding_divisor(GLuint binding, GLuint divisor) const {
+    if(direct_state_access()) {
+        glVertexArrayBindingDivisor(m_handle, binding, divisor);
+    } else {
+        bind();
+        glVertexBindingDivisor(binding, divisor);
+    }
+}
+
+void gl::vertex_array::enable_attrib(GLuint location) const {
+    if(direct_state_access()) {
+        glEnableVertexArrayAttrib(m_handle, location);
+    } else {
+        bind();
+        glEnableVertexAttribArray(location);
+    }
 }
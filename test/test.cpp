@@ -3,12 +3,71 @@
 //
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <list>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
 
+#include "gl++/background_uploader.h"
+#include "gl++/buffer_arena.h"
+#include "gl++/command_queue.h"
+#include "gl++/compute_pipeline.h"
+#include "gl++/deletion_queue.h"
+#include "gl++/draw_batch.h"
+#include "gl++/instance_buffer.h"
+#include "gl++/mesh_file.h"
+#include "gl++/mesh_optimizer.h"
+#include "gl++/packed_encode.h"
+#include "gl++/profiler.h"
+#include "gl++/program_cache.h"
+#include "gl++/readback.h"
+#include "gl++/shader_batch.h"
+#include "gl++/shader_variants.h"
+#include "gl++/state_cache.h"
+#include "gl++/transform_feedback.h"
+#include "gl++/stream_buffer.h"
+#include "gl++/uniform_block.h"
+#include "gl++/vertex_array.h"
 #include "gl++/vertex_buffer.h"
+#include "gl++/vertex_layout.h"
 
 #include <GLFW/glfw3.h>
 
+class framebuffer_fixture {
+public:
+    framebuffer_fixture(GLsizei width, GLsizei height) : width(width), height(height) {
+        glGenFramebuffers(1, &fbo);
+        glGenRenderbuffers(1, &rbo);
+        glBindRenderbuffer(GL_RENDERBUFFER, rbo);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rbo);
+        glViewport(0, 0, width, height);
+        glClearColor(0, 0, 0, 0);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    ~framebuffer_fixture() {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteRenderbuffers(1, &rbo);
+    }
+    std::vector<GLubyte> pixels() const {
+        std::vector<GLubyte> data(width * height * 4);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+        return data;
+    }
+private:
+    GLsizei width, height;
+    GLuint fbo, rbo;
+};
+
 TEST(BUFFER_READ, BUFFER_TEST) {
     std::vector<float> data { 1, 2, 3 };
     gl::vertex_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo(data.begin(), data.end());
@@ -141,8 +200,1524 @@ TEST(BUFFER_EXTEND, BUFFER_TEST) {
     EXPECT_EQ(vbo.capacity(), 8);
 }
 
+TEST(BUFFER_RESERVE, BUFFER_TEST) {
+    std::vector<float> data { 1, 2, 3 };
+    std::vector<float> buffer(6);
+    gl::vertex_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo(data.begin(), data.end());
+
+    // reserve keeps the contents
+    vbo.reserve(16);
+    EXPECT_EQ(vbo.size(), 3);
+    EXPECT_EQ(vbo.capacity(), 16);
+    vbo.get(buffer.begin(), buffer.begin() + 3);
+    for(std::size_t i = 0; i < data.size(); i++) {
+        EXPECT_EQ(buffer[i], data[i]);
+    }
+
+    // smaller reservation does nothing
+    auto handle = vbo.handle();
+    vbo.reserve(4);
+    EXPECT_EQ(vbo.capacity(), 16);
+    EXPECT_EQ(vbo.handle(), handle);
+
+    // extend within the reservation keeps the storage
+    std::vector<float> extend1 { 4, 5, 6 };
+    vbo.extend(extend1.begin(), extend1.end());
+    EXPECT_EQ(vbo.handle(), handle);
+    EXPECT_EQ(vbo.capacity(), 16);
+    vbo.get(buffer.begin(), buffer.end());
+    for(std::size_t i = 0; i < data.size(); i++) {
+        EXPECT_EQ(buffer[i], data[i]);
+        EXPECT_EQ(buffer[i + 3], extend1[i]);
+    }
+
+    // caller supplied growth policy
+    std::vector<float> extend2(20, 7);
+    vbo.extend(extend2.begin(), extend2.end(), [](std::size_t, std::size_t required) {
+        return required + required / 2;
+    });
+    EXPECT_EQ(vbo.size(), 26);
+    EXPECT_EQ(vbo.capacity(), 39);
+    buffer.resize(vbo.size());
+    vbo.get(buffer.begin(), buffer.end());
+    for(std::size_t i = 0; i < data.size(); i++) {
+        EXPECT_EQ(buffer[i], data[i]);
+        EXPECT_EQ(buffer[i + 3], extend1[i]);
+    }
+    for(std::size_t i = 6; i < buffer.size(); i++) {
+        EXPECT_EQ(buffer[i], 7);
+    }
+}
+
+TEST(BUFFER_SPAN, BUFFER_TEST) {
+    std::vector<float> data { 1, 2, 3 };
+    std::vector<float> buffer(3);
+
+    // construct from contiguous memory
+    gl::vertex_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo1(gl::span<const float> { data });
+    vbo1.get(gl::span<float>(buffer));
+    for(std::size_t i = 0; i < data.size(); i++) {
+        EXPECT_EQ(buffer[i], data[i]);
+    }
+    gl::vertex_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo2(data.data(), data.size());
+    EXPECT_EQ(vbo2.size(), data.size());
+
+    // uninitialized storage
+    gl::vertex_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo3(5);
+    EXPECT_EQ(vbo3.size(), 5);
+    EXPECT_EQ(vbo3.capacity(), 5);
+
+    // modify and read a part of buffer
+    std::vector<float> modify1 { 4, 5 };
+    vbo3.modify(1, modify1);
+    vbo3.modify(3, modify1.data(), modify1.size());
+    std::vector<float> buffer2(4);
+    vbo3.get(1, buffer2.data(), buffer2.size());
+    EXPECT_EQ(buffer2[0], 4);
+    EXPECT_EQ(buffer2[1], 5);
+    EXPECT_EQ(buffer2[2], 4);
+    EXPECT_EQ(buffer2[3], 5);
+
+    // read and write over size buffer
+    std::vector<float> buffer3(3);
+    vbo1.modify(2, modify1);
+    vbo1.get(2, gl::span<float>(buffer3));
+    EXPECT_EQ(buffer3[0], 4);
+    EXPECT_EQ(buffer3[1], 0);
+
+    // extend
+    vbo1.extend(gl::span<const float>(modify1));
+    EXPECT_EQ(vbo1.size(), 5);
+    EXPECT_EQ(vbo1.capacity(), 8);
+    std::vector<float> answer { 1, 2, 4, 4, 5 };
+    std::vector<float> buffer4(answer.size());
+    vbo1.get(buffer4);
+    for(std::size_t i = 0; i < answer.size(); i++) {
+        EXPECT_EQ(buffer4[i], answer[i]);
+    }
+}
+
+TEST(BUFFER_READ_ASYNC, BUFFER_TEST) {
+    std::vector<float> data { 1, 2, 3, 4 };
+    gl::vertex_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo(data.begin(), data.end());
+
+    // read all buffer
+    auto result1 = gl::get_async(vbo);
+    EXPECT_EQ(result1.size(), data.size());
+    auto buffer1 = result1.get();
+    EXPECT_TRUE(result1.ready());
+    for(std::size_t i = 0; i < data.size(); i++) {
+        EXPECT_EQ(buffer1[i], data[i]);
+    }
+
+    // read over size buffer
+    auto result2 = gl::get_async(vbo, 2, 5);
+    EXPECT_EQ(result2.size(), 2);
+    result2.wait();
+    std::vector<float> buffer2(4);
+    result2.get(gl::span<float>(buffer2));
+    EXPECT_EQ(buffer2[0], data[2]);
+    EXPECT_EQ(buffer2[1], data[3]);
+    EXPECT_EQ(buffer2[2], 0);
+
+    // modification after the request does not change the result
+    auto result3 = gl::get_async(vbo, 0, 1);
+    std::vector<float> modify { 9 };
+    vbo.modify(modify);
+    EXPECT_EQ(result3.get()[0], data[0]);
+
+    // read mismatch area
+    auto result4 = gl::get_async(vbo, 4, 1);
+    EXPECT_EQ(result4.size(), 0);
+    EXPECT_TRUE(result4.ready());
+}
+
+TEST(MESH_OPTIMIZE, BUFFER_TEST) {
+    // unindexed 16 x 16 grid with the triangles in random order
+    std::vector<std::array<glm::vec2, 3>> triangles;
+    for(float y = 0; y < 16; y++) {
+        for(float x = 0; x < 16; x++) {
+            glm::vec2 p00(x, y), p10(x + 1, y), p01(x, y + 1), p11(x + 1, y + 1);
+            triangles.push_back({ p00, p10, p11 });
+            triangles.push_back({ p00, p11, p01 });
+        }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(1));
+    std::vector<glm::vec2> vertices;
+    std::vector<GLuint> indices;
+    for(const auto& triangle : triangles) {
+        for(const auto& p : triangle) {
+            indices.push_back(vertices.size());
+            vertices.push_back(p);
+        }
+    }
+
+    auto mesh = gl::optimize_mesh<glm::vec2>(vertices, indices);
+    EXPECT_EQ(mesh.vertices.size(), 17 * 17);
+    EXPECT_EQ(mesh.index_type(), GL_UNSIGNED_SHORT);
+    EXPECT_EQ(mesh.index_count(), indices.size());
+    EXPECT_FLOAT_EQ(mesh.acmr_before, 3.0f);
+    EXPECT_LT(mesh.acmr_after, 1.0f);
+
+    // same triangles with the same winding, and vertices in the order they are first used
+    auto key = [](glm::vec2 a, glm::vec2 b, glm::vec2 c) {
+        // rotate so the smallest vertex comes first
+        std::array<std::pair<float, float>, 3> t { { { a.x, a.y }, { b.x, b.y }, { c.x, c.y } } };
+        std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+        return t;
+    };
+    std::vector<std::array<std::pair<float, float>, 3>> expected, actual;
+    for(const auto& t : triangles) expected.push_back(key(t[0], t[1], t[2]));
+    GLushort next = 0;
+    for(std::size_t i = 0; i < mesh.short_indices.size(); i += 3) {
+        const auto* t = &mesh.short_indices[i];
+        actual.push_back(key(mesh.vertices[t[0]], mesh.vertices[t[1]], mesh.vertices[t[2]]));
+        for(int k = 0; k < 3; k++) {
+            EXPECT_LE(t[k], next);
+            if(t[k] == next) next++;
+        }
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    EXPECT_EQ(actual, expected);
+
+    // narrowed indices go straight into an element buffer
+    gl::vertex_buffer<gl::buffer_trait<GLushort, GL_ELEMENT_ARRAY_BUFFER, GL_STATIC_DRAW>> ibo(mesh.short_indices.begin(), mesh.short_indices.end());
+    std::vector<GLushort> uploaded(mesh.short_indices.size());
+    ibo.get(0, uploaded.begin(), uploaded.end());
+    EXPECT_EQ(uploaded, mesh.short_indices);
+
+    // too many vertices for GLushort keeps 32 bit indices
+    std::vector<GLuint> large(70000 * 3);
+    std::iota(large.begin(), large.end(), 0);
+    std::vector<float> large_vertices(large.size());
+    std::iota(large_vertices.begin(), large_vertices.end(), 0.0f);
+    auto large_mesh = gl::optimize_mesh<float>(large_vertices, large);
+    EXPECT_EQ(large_mesh.index_type(), GL_UNSIGNED_INT);
+    EXPECT_EQ(large_mesh.indices, large);
+}
+
+TEST(BUFFER_ARENA, BUFFER_TEST) {
+    gl::buffer_arena arena(GL_ARRAY_BUFFER, GL_STATIC_DRAW, 256);
+    std::vector<float> data1 { 1, 2, 3, 4 };
+    std::vector<float> data2 { 5, 6, 7, 8, 9, 10, 11, 12 };
+
+    // sub-ranges share one buffer object
+    auto range1 = arena.allocate<float>(data1.size());
+    auto range2 = arena.allocate<float>(data2.size());
+    EXPECT_EQ(range1.handle(), range2.handle());
+    EXPECT_EQ(range1.size(), data1.size());
+    EXPECT_EQ(range2.first(), data1.size());
+    range1.modify(gl::span<const float>(data1));
+    range2.modify(gl::span<const float>(data2));
+
+    std::vector<float> buffer(data2.size());
+    range1.get(gl::span<float>(buffer));
+    for(std::size_t i = 0; i < data1.size(); i++) {
+        EXPECT_EQ(buffer[i], data1[i]);
+    }
+
+    // over size modification is clipped to the range
+    std::vector<float> modify { 20, 21, 22 };
+    range1.modify(2, gl::span<const float>(modify));
+    range2.get(gl::span<float>(buffer));
+    EXPECT_EQ(buffer[0], data2[0]);
+
+    auto stats1 = arena.stats();
+    EXPECT_EQ(stats1.blocks, 1);
+    EXPECT_EQ(stats1.capacity, 256);
+    EXPECT_EQ(stats1.used, (data1.size() + data2.size()) * sizeof(float));
+    EXPECT_EQ(stats1.allocations, 2);
+
+    // replacing the first range leaves a hole at the front
+    {
+        auto range3 = arena.allocate<float>(4);
+        range1 = std::move(range3);
+    }
+    EXPECT_EQ(arena.stats().allocations, 2);
+    EXPECT_EQ(arena.stats().free_ranges, 2);
+    EXPECT_GT(arena.stats().fragmentation(), 0.0);
+
+    // defragmentation moves live data to the front
+    arena.defragment();
+    auto stats2 = arena.stats();
+    EXPECT_EQ(stats2.free_ranges, 1);
+    EXPECT_EQ(stats2.fragmentation(), 0.0);
+    EXPECT_EQ(range2.first(), 0);
+    range2.get(gl::span<float>(buffer));
+    for(std::size_t i = 0; i < data2.size(); i++) {
+        EXPECT_EQ(buffer[i], data2[i]);
+    }
+
+    // allocations larger than a block get their own block
+    auto large = arena.allocate<float>(128);
+    EXPECT_NE(large.handle(), range2.handle());
+    EXPECT_EQ(arena.stats().blocks, 2);
+}
+
+TEST(BACKGROUND_UPLOAD, BUFFER_TEST) {
+    using traits = gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STATIC_DRAW>;
+    auto window = glfwGetCurrentContext();
+    auto shared = glfwCreateWindow(1, 1, "upload", nullptr, window);
+    ASSERT_NE(shared, nullptr);
+
+    std::vector<float> data(1 << 16);
+    std::iota(data.begin(), data.end(), 0.0f);
+    std::list<float> list { 1, 2, 3 };
+    {
+        gl::background_uploader uploader([shared]() { glfwMakeContextCurrent(shared); }, []() { glfwMakeContextCurrent(nullptr); });
+        auto ticket1 = uploader.upload<traits>(data.begin(), data.end());
+        auto ticket2 = uploader.upload<traits>(list.begin(), list.end());
+        auto ticket3 = uploader.upload<traits>(std::vector<float>());
+        while(!ticket1.ready() || !ticket2.ready() || !ticket3.ready()) {
+            std::this_thread::yield();
+        }
+        EXPECT_EQ(uploader.pending(), 0);
+
+        // the buffers are created on the worker's context and used on this one
+        auto vbo = ticket1.take();
+        EXPECT_EQ(vbo.size(), data.size());
+        std::vector<float> buffer(data.size());
+        vbo.get(0, buffer.begin(), buffer.end());
+        EXPECT_EQ(buffer, data);
+
+        std::vector<float> buffer2(3);
+        ticket2.get().get(0, buffer2.begin(), buffer2.end());
+        EXPECT_EQ(buffer2, std::vector<float>(list.begin(), list.end()));
+        EXPECT_EQ(ticket3.get().size(), 0);
+
+        // a queued job finishes before the uploader is destroyed
+        auto ticket4 = uploader.upload<traits>(list.begin(), list.end());
+        uploader.flush();
+        EXPECT_TRUE(ticket4.done());
+        EXPECT_TRUE(ticket4.wait_gpu());
+        // the fence of a ready ticket is gone, there is nothing left to wait for
+        EXPECT_TRUE(ticket1.wait_gpu());
+    }
+    // a ticket without an upload reports it instead of skipping the wait
+    EXPECT_FALSE(gl::upload_ticket<traits>().wait_gpu());
+    glfwDestroyWindow(shared);
+}
+
+TEST(STREAM_BUFFER_WRITE, BUFFER_TEST) {
+    gl::stream_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STREAM_DRAW>> sbo(4);
+    ASSERT_TRUE(sbo.valid());
+    EXPECT_EQ(sbo.size(), 4);
+    EXPECT_EQ(sbo.capacity(), 4 * decltype(sbo)::region_count);
+
+    std::vector<float> buffer(sbo.size());
+    for(std::size_t frame = 0; frame < 2 * decltype(sbo)::region_count; frame++) {
+        EXPECT_EQ(sbo.region(), frame % decltype(sbo)::region_count);
+        EXPECT_EQ(sbo.offset(), sbo.region() * sbo.size());
+
+        // fill the region in place
+        auto region = sbo.map();
+        EXPECT_EQ(region.size(), sbo.size());
+        for(std::size_t i = 0; i < region.size(); i++) {
+            region[i] = static_cast<float>(frame * 10 + i);
+        }
+
+        // coherent mapping makes the writes visible without flush
+        sbo.bind();
+        glGetBufferSubData(GL_ARRAY_BUFFER, sbo.offset() * sizeof(float), buffer.size() * sizeof(float), buffer.data());
+        for(std::size_t i = 0; i < buffer.size(); i++) {
+            EXPECT_EQ(buffer[i], static_cast<float>(frame * 10 + i));
+        }
+        sbo.fence();
+    }
+    EXPECT_LE(sbo.wait_count(), 2 * decltype(sbo)::region_count);
+
+    // with a single region and a slow draw before each fence, the next map() has to wait for the GPU
+    framebuffer_fixture framebuffer(128, 128);
+    gl::shader_program slow;
+    slow.add_shader(R"(
+#version 430 core
+void main() {
+    gl_Position = vec4(vec2(gl_VertexID == 1 ? 3.0 : -1.0, gl_VertexID == 2 ? 3.0 : -1.0), 0.0, 1.0);
+}
+)", GL_VERTEX_SHADER);
+    slow.add_shader(R"(
+#version 430 core
+out vec4 frag;
+void main() {
+    float value = gl_FragCoord.x;
+    for(int i = 0; i < 1000; i++) value = sin(value) * 1.5 + 0.1;
+    frag = vec4(value);
+}
+)", GL_FRAGMENT_SHADER);
+    ASSERT_TRUE(slow.link());
+    gl::vertex_array vao;
+    gl::stream_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STREAM_DRAW>, 1> single(4);
+    ASSERT_TRUE(single.valid());
+    slow.use();
+    vao.bind();
+    for(int frame = 0; frame < 4; frame++) {
+        auto region = single.map();
+        std::fill(region.begin(), region.end(), static_cast<float>(frame));
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        single.fence();
+    }
+    vao.unbind();
+    slow.unuse();
+    EXPECT_GT(single.wait_count(), 0);
+    EXPECT_GT(single.wait_time().count(), 0);
+
+    // an empty buffer cannot be mapped
+    gl::stream_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STREAM_DRAW>> empty(0);
+    EXPECT_FALSE(empty.valid());
+    EXPECT_EQ(empty.map().size(), 0);
+
+    sbo.reset_counters();
+    EXPECT_EQ(sbo.wait_count(), 0);
+    EXPECT_EQ(sbo.wait_time().count(), 0);
+}
+
+TEST(VERTEX_ARRAY_POINTER, VERTEX_ARRAY_TEST) {
+    struct vertex {
+        float position[3];
+        GLint id;
+    };
+    std::vector<vertex> data { { { 0, 1, 2 }, 3 }, { { 4, 5, 6 }, 7 } };
+    gl::vertex_buffer<gl::buffer_trait<vertex, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo(data.begin(), data.end());
+
+    gl::vertex_array vao;
+    vbo.vertex_pointer(vao, 1, GL_FALSE, &vertex::id);
+
+    GLint enabled, size, type, stride, integer, binding;
+    vao.bind();
+    glGetVertexAttribiv(1, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &enabled);
+    glGetVertexAttribiv(1, GL_VERTEX_ATTRIB_ARRAY_SIZE, &size);
+    glGetVertexAttribiv(1, GL_VERTEX_ATTRIB_ARRAY_TYPE, &type);
+    glGetIntegeri_v(GL_VERTEX_BINDING_STRIDE, 1, &stride);
+    glGetVertexAttribiv(1, GL_VERTEX_ATTRIB_ARRAY_INTEGER, &integer);
+    glGetVertexAttribiv(1, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &binding);
+    vao.unbind();
+    EXPECT_EQ(enabled, GL_TRUE);
+    EXPECT_EQ(size, 1);
+    EXPECT_EQ(type, GL_INT);
+    EXPECT_EQ(stride, sizeof(vertex));
+    EXPECT_EQ(integer, GL_TRUE);
+    EXPECT_EQ(binding, vbo.handle());
+}
+
+TEST(PACKED_ATTRIBUTE, VERTEX_ARRAY_TEST) {
+    // long enough for both the vectorized loops and their scalar tails
+    std::vector<float> values(37);
+    for(std::size_t i = 0; i < values.size(); i++) {
+        values[i] = -1.25f + i * (2.5f / (values.size() - 1));
+    }
+    values[0] = NAN;
+    auto halves = gl::encode<gl::half>(values);
+    auto snorms = gl::encode<gl::snorm8>(values);
+    auto unorms = gl::encode<gl::unorm16>(values);
+    for(std::size_t i = 1; i < values.size(); i++) {
+        EXPECT_NEAR(gl::decode(halves[i]), values[i], 1e-3f);
+        EXPECT_NEAR(gl::decode(snorms[i]), std::clamp(values[i], -1.0f, 1.0f), 1.0f / 254);
+        EXPECT_NEAR(gl::decode(unorms[i]), std::clamp(values[i], 0.0f, 1.0f), 1.0f / 131070);
+    }
+    EXPECT_TRUE(std::isnan(gl::decode(halves[0])));
+    EXPECT_EQ(snorms[0].value, -127);
+    EXPECT_EQ(gl::encode<gl::half>(std::vector<float> { 1.0f, 65520.0f, 5.96046448e-8f }).back().bits, 0x0001);
+    EXPECT_EQ(gl::encode<gl::half>(std::vector<float> { 1.0f, 65520.0f }).back().bits, 0x7c00);
+    EXPECT_EQ(gl::encode<gl::unorm8>(std::vector<float> { 0.5f }).front().value, 128);
+
+    std::vector<glm::vec4> normals { { 1, 0, -1, 1 }, { 0.5f, -0.5f, 0, -1 }, { 0, 1, 0, 0 }, { -1, -1, -1, -1 }, { 0.25f, 0.75f, -2, 0 } };
+    auto packed = gl::encode<gl::snorm_2_10_10_10>(normals);
+    EXPECT_EQ(packed[0].bits, 0x1ffu | 0x201u << 20 | 0x1u << 30);
+    for(std::size_t i = 0; i < normals.size(); i++) {
+        auto decoded = gl::decode(packed[i]);
+        for(int c = 0; c < 4; c++) {
+            EXPECT_NEAR(decoded[c], std::clamp(normals[i][c], -1.0f, 1.0f), 1.0f / 1022);
+        }
+    }
+
+    struct vertex {
+        std::array<gl::half, 4> position;
+        gl::snorm_2_10_10_10 normal;
+        std::array<gl::unorm8, 4> color;
+    };
+    std::vector<vertex> data(2);
+    gl::vertex_buffer<gl::buffer_trait<vertex, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo(data.begin(), data.end());
+    gl::vertex_array vao;
+    vbo.vertex_pointer(vao, 0, GL_FALSE, &vertex::position);
+    vbo.vertex_pointer(vao, 1, GL_FALSE, &vertex::normal);
+    vbo.vertex_pointer(vao, 2, GL_FALSE, &vertex::color);
+
+    GLint size[3], type[3], normalized[3], integer[3];
+    if(auto ctx = vao.get_bind()) {
+        for(GLuint i = 0; i < 3; i++) {
+            glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_SIZE, size + i);
+            glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_TYPE, type + i);
+            glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_NORMALIZED, normalized + i);
+            glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_INTEGER, integer + i);
+        }
+    }
+    EXPECT_EQ(size[0], 4);
+    EXPECT_EQ(type[0], GL_HALF_FLOAT);
+    EXPECT_EQ(integer[0], GL_FALSE);
+    EXPECT_EQ(size[1], 4);
+    EXPECT_EQ(type[1], GL_INT_2_10_10_10_REV);
+    EXPECT_EQ(normalized[1], GL_TRUE);
+    EXPECT_EQ(size[2], 4);
+    EXPECT_EQ(type[2], GL_UNSIGNED_BYTE);
+    EXPECT_EQ(normalized[2], GL_TRUE);
+    EXPECT_EQ(integer[2], GL_FALSE);
+}
+
+static const char* vertex_shader_source = R"(
+#version 330 core
+layout(location = 0) in vec3 position;
+void main() {
+    gl_Position = vec4(position, 1.0);
+}
+)";
+
+static const char* fragment_shader_source = R"(
+#version 330 core
+out vec4 color;
+void main() {
+    color = vec4(1.0);
+}
+)";
+
+TEST(PROGRAM_CACHE, SHADER_TEST) {
+    auto directory = std::filesystem::temp_directory_path() / "gl++_program_cache_test";
+    std::filesystem::remove_all(directory);
+    std::vector<gl::shader_source> sources {
+        { vertex_shader_source, GL_VERTEX_SHADER },
+        { fragment_shader_source, GL_FRAGMENT_SHADER }
+    };
+    gl::program_cache cache(directory.string());
+
+    // first build compiles from source
+    gl::shader_program program1;
+    EXPECT_TRUE(cache.build(program1, sources));
+    EXPECT_EQ(cache.hits(), 0);
+    EXPECT_EQ(cache.misses(), 1);
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if(formats == 0) GTEST_SKIP() << "program binaries are not supported";
+
+    // second build loads the binary
+    gl::shader_program program2;
+    EXPECT_TRUE(cache.build(program2, sources));
+    EXPECT_EQ(cache.hits(), 1);
+    EXPECT_EQ(cache.misses(), 1);
+
+    // broken binary falls back to compiling
+    for(const auto& entry : std::filesystem::directory_iterator(directory)) {
+        std::ofstream fout(entry.path(), std::ios::binary | std::ios::trunc);
+        fout << "broken binary";
+    }
+    gl::shader_program program3;
+    EXPECT_TRUE(cache.build(program3, sources));
+    EXPECT_EQ(cache.rejected(), 1);
+    EXPECT_EQ(cache.misses(), 2);
+
+    gl::shader_program program4;
+    EXPECT_TRUE(cache.build(program4, sources));
+    EXPECT_EQ(cache.hits(), 2);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(COMMAND_QUEUE, STATE_TEST) {
+    using traits = gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STATIC_DRAW>;
+    gl::command_queue queue;
+    constexpr std::size_t thread_count = 4;
+    std::vector<gl::pending<gl::vertex_buffer<traits>>> buffers(thread_count);
+    std::vector<gl::pending<gl::vertex_array>> arrays(thread_count);
+
+    // workers record without a context
+    std::vector<std::thread> workers;
+    for(std::size_t i = 0; i < thread_count; i++) {
+        workers.emplace_back([&, i]() {
+            auto& list = queue.acquire();
+            std::vector<float> data { float(i), float(i), float(i), float(i) };
+            buffers[i] = list.create_buffer<traits>(gl::span<const float>(data));
+            data.assign(2, float(i * 10));
+            list.modify(buffers[i], 2, gl::span<const float>(data));
+            arrays[i] = list.create_vertex_array();
+            list.vertex_pointer(arrays[i], buffers[i], 0, GL_FALSE, gl::this_select);
+            queue.submit(list);
+        });
+    }
+    for(auto& worker : workers) {
+        worker.join();
+    }
+    auto& list = queue.acquire();
+    auto program = list.build_program({
+        { vertex_shader_source, GL_VERTEX_SHADER },
+        { fragment_shader_source, GL_FRAGMENT_SHADER }
+    });
+    auto broken = list.build_program({ { "#version 330 core\nvoid main() { error }", GL_VERTEX_SHADER } });
+    EXPECT_FALSE(program.ready());
+    queue.submit(list);
+
+    // replay in batches on the GL thread
+    EXPECT_EQ(queue.replay(2), 2);
+    EXPECT_EQ(queue.replay(), thread_count - 1);
+    EXPECT_EQ(queue.replay(), 0);
+    EXPECT_TRUE(program.ready());
+    EXPECT_TRUE(program->enabled());
+    EXPECT_TRUE(broken.ready());
+    EXPECT_FALSE(broken->enabled());
+    for(std::size_t i = 0; i < thread_count; i++) {
+        ASSERT_TRUE(buffers[i].ready());
+        std::vector<float> buffer(4);
+        buffers[i]->get(0, buffer.begin(), buffer.end());
+        EXPECT_EQ(buffer[0], float(i));
+        EXPECT_EQ(buffer[1], float(i));
+        EXPECT_EQ(buffer[2], float(i * 10));
+        EXPECT_EQ(buffer[3], float(i * 10));
+
+        ASSERT_TRUE(arrays[i].ready());
+        GLint binding;
+        arrays[i]->bind();
+        glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &binding);
+        EXPECT_EQ(binding, buffers[i]->handle());
+    }
+    arrays[0]->unbind();
+
+    // replayed lists are reused
+    auto lists = queue.lists();
+    auto& reused = queue.acquire();
+    EXPECT_TRUE(reused.empty());
+    queue.submit(reused);
+    queue.replay();
+    EXPECT_EQ(queue.lists(), lists);
+}
+
+static const char* compute_shader_source = R"(
+#version 430 core
+layout(local_size_x = 64) in;
+layout(std430) buffer Input {
+    float a[];
+};
+layout(std430) buffer Output {
+    float b[];
+};
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if(i >= a.length()) return;
+    b[i] = a[i] * 2.0;
+}
+)";
+
+TEST(COMPUTE_PIPELINE, SHADER_TEST) {
+    using namespace gl::literals;
+    using storage_buffer = gl::vertex_buffer<gl::buffer_trait<float, GL_SHADER_STORAGE_BUFFER, GL_DYNAMIC_COPY>>;
+    auto build = []() {
+        gl::shader_program program;
+        program.add_shader(compute_shader_source, GL_COMPUTE_SHADER);
+        program.link();
+        return gl::compute_pipeline(std::move(program));
+    };
+    gl::current_barriers().invalidate();
+    gl::current_barriers().reset_statistics();
+
+    std::vector<float> data(100);
+    std::iota(data.begin(), data.end(), 0.0f);
+    storage_buffer input(data.begin(), data.end()), middle(data.size()), output(data.size());
+
+    auto doubling = build();
+    ASSERT_TRUE(doubling.valid());
+    EXPECT_EQ(doubling.work_group_size()[0], 64);
+    EXPECT_EQ(doubling.work_group_size()[1], 1);
+    EXPECT_TRUE(doubling.bind("Input"_name, input, gl::buffer_access::read));
+    EXPECT_TRUE(doubling.bind("Output"_name, middle, gl::buffer_access::write));
+    EXPECT_FALSE(doubling.bind("Missing"_name, middle));
+    auto chained = build();
+    chained.bind("Input"_name, middle, gl::buffer_access::read);
+    chained.bind("Output"_name, output, gl::buffer_access::write);
+
+    // 100 invocations round up to 2 groups of 64
+    doubling.dispatch_invocations(data.size());
+    EXPECT_EQ(gl::current_barriers().issued(), 0);
+    // reading what the previous dispatch wrote needs a storage barrier
+    chained.dispatch_invocations(data.size());
+    EXPECT_EQ(gl::current_barriers().issued(), 1);
+    // overwriting middle after it was read needs none
+    doubling.dispatch_invocations(data.size());
+    EXPECT_EQ(gl::current_barriers().issued(), 1);
+    EXPECT_EQ(gl::current_barriers().pending(input.handle()), 0);
+
+    // reading back waits for the dispatch with a buffer update barrier
+    std::vector<float> result(data.size());
+    output.get(0, result.begin(), result.end());
+    EXPECT_EQ(gl::current_barriers().issued(), 2);
+    for(std::size_t i = 0; i < data.size(); i++) EXPECT_EQ(result[i], data[i] * 4);
+    output.get(0, result.begin(), result.end());
+    EXPECT_EQ(gl::current_barriers().issued(), 2);
+
+    // group counts from a buffer, only the first group runs
+    gl::vertex_buffer<gl::buffer_trait<gl::dispatch_indirect_command, GL_DISPATCH_INDIRECT_BUFFER, GL_STATIC_DRAW>> commands(
+            std::vector<gl::dispatch_indirect_command> { { 1, 1, 1 } });
+    storage_buffer partial(std::vector<float>(data.size(), -1.0f));
+    doubling.bind("Output"_name, partial);
+    doubling.dispatch_indirect(commands);
+    partial.get(0, result.begin(), result.end());
+    EXPECT_EQ(result[63], data[63] * 2);
+    EXPECT_EQ(result[64], -1.0f);
+
+    // growing copies the buffer on the GPU, which waits for the dispatch as well
+    doubling.bind("Output"_name, middle);
+    doubling.dispatch_invocations(data.size());
+    auto issued = gl::current_barriers().issued();
+    middle.reserve(256);
+    EXPECT_EQ(gl::current_barriers().issued(), issued + 1);
+    middle.get(0, result.begin(), result.end());
+    for(std::size_t i = 0; i < data.size(); i++) EXPECT_EQ(result[i], data[i] * 2);
+
+    // so does an asynchronous readback. the storage moved, so it is bound again
+    doubling.bind("Output"_name, middle);
+    doubling.dispatch_invocations(data.size());
+    issued = gl::current_barriers().issued();
+    auto readback = gl::get_async(middle);
+    EXPECT_EQ(gl::current_barriers().issued(), issued + 1);
+    auto copied = readback.get();
+    for(std::size_t i = 0; i < data.size(); i++) EXPECT_EQ(copied[i], data[i] * 2);
+
+    // a retired buffer leaves nothing behind for the next one with its name
+    doubling.dispatch_invocations(data.size());
+    auto retired = middle.handle();
+    EXPECT_NE(gl::current_barriers().pending(retired), 0);
+    middle = storage_buffer(std::size_t(0));
+    EXPECT_EQ(gl::current_barriers().pending(retired), 0);
+
+    // not a compute program
+    gl::shader_program graphics;
+    graphics.add_shader(vertex_shader_source, GL_VERTEX_SHADER);
+    graphics.add_shader(fragment_shader_source, GL_FRAGMENT_SHADER);
+    graphics.link();
+    gl::compute_pipeline invalid(std::move(graphics));
+    EXPECT_FALSE(invalid.valid());
+    EXPECT_EQ(glGetError(), GL_NO_ERROR);
+    gl::current_state().use_program(0);
+}
+
+// SPIR-V 1.0 of
+//   layout(local_size_x = 1) in;
+//   layout(constant_id = 0) const uint scale = 1;
+//   layout(constant_id = 1) const uint offset = 0;
+//   layout(std430, binding = 0) buffer Out { uint value; };
+//   void main() { value = scale + offset; }
+static const std::uint32_t spirv_compute_words[] = {
+    0x07230203, 0x00010000, 0, 16, 0,
+    (2 << 16) | 17, 1,                                  // OpCapability Shader
+    (3 << 16) | 14, 0, 1,                               // OpMemoryModel Logical GLSL450
+    (5 << 16) | 15, 5, 1, 0x6e69616d, 0,                // OpEntryPoint GLCompute %1 "main"
+    (6 << 16) | 16, 1, 17, 1, 1, 1,                     // OpExecutionMode %1 LocalSize 1 1 1
+    (4 << 16) | 71, 5, 1, 0,                            // OpDecorate %5 SpecId 0
+    (4 << 16) | 71, 6, 1, 1,                            // OpDecorate %6 SpecId 1
+    (5 << 16) | 72, 7, 0, 35, 0,                        // OpMemberDecorate %7 0 Offset 0
+    (3 << 16) | 71, 7, 3,                               // OpDecorate %7 BufferBlock
+    (4 << 16) | 71, 10, 33, 0,                          // OpDecorate %10 Binding 0
+    (2 << 16) | 19, 2,                                  // %2 = OpTypeVoid
+    (3 << 16) | 33, 3, 2,                               // %3 = OpTypeFunction %2
+    (4 << 16) | 21, 4, 32, 0,                           // %4 = OpTypeInt 32 0
+    (4 << 16) | 50, 4, 5, 1,                            // %5 = OpSpecConstant %4 1
+    (4 << 16) | 50, 4, 6, 0,                            // %6 = OpSpecConstant %4 0
+    (3 << 16) | 30, 7, 4,                               // %7 = OpTypeStruct %4
+    (4 << 16) | 32, 8, 2, 7,                            // %8 = OpTypePointer Uniform %7
+    (4 << 16) | 32, 9, 2, 4,                            // %9 = OpTypePointer Uniform %4
+    (4 << 16) | 59, 8, 10, 2,                           // %10 = OpVariable %8 Uniform
+    (4 << 16) | 21, 11, 32, 1,                          // %11 = OpTypeInt 32 1
+    (4 << 16) | 43, 11, 12, 0,                          // %12 = OpConstant %11 0
+    (5 << 16) | 54, 2, 1, 0, 3,                         // %1 = OpFunction %2 None %3
+    (2 << 16) | 248, 13,                                // %13 = OpLabel
+    (5 << 16) | 128, 4, 14, 5, 6,                       // %14 = OpIAdd %4 %5 %6
+    (5 << 16) | 65, 9, 15, 10, 12,                      // %15 = OpAccessChain %9 %10 %12
+    (3 << 16) | 62, 15, 14,                             // OpStore %15 %14
+    (1 << 16) | 253,                                    // OpReturn
+    (1 << 16) | 56                                      // OpFunctionEnd
+};
+
+TEST(SHADER_VARIANTS, SHADER_TEST) {
+    std::string binary(reinterpret_cast<const char*>(spirv_compute_words), sizeof(spirv_compute_words));
+    auto ids = gl::specialization_ids(binary);
+    ASSERT_EQ(ids.size(), 2);
+    EXPECT_EQ(ids[0], 0);
+    EXPECT_EQ(ids[1], 1);
+    EXPECT_TRUE(gl::specialization_ids("not spir-v").empty());
+    EXPECT_EQ(gl::specialization_constant::of(0, 1.0f).value, 0x3f800000u);
+    EXPECT_EQ(gl::specialization_constant::of(0, true).value, 1u);
+    if(!GLEW_VERSION_4_6 && !GLEW_ARB_gl_spirv) GTEST_SKIP() << "SPIR-V shaders are not supported";
+
+    gl::shader_variants variants({ gl::spirv_stage { binary, GL_COMPUTE_SHADER } });
+    gl::vertex_buffer<gl::buffer_trait<GLuint, GL_SHADER_STORAGE_BUFFER, GL_STATIC_DRAW>> result(1);
+    auto run = [&](gl::shader_program* program) {
+        program->use();
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, result.handle());
+        glDispatchCompute(1, 1, 1);
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        program->unuse();
+        GLuint value = 0;
+        result.get(&value, &value + 1);
+        return value;
+    };
+    auto seven = variants.get({ gl::specialization_constant { 0, 3 }, gl::specialization_constant { 1, 4 } });
+    ASSERT_NE(seven, nullptr);
+    EXPECT_EQ(run(seven), 7);
+    // unlisted constants keep their defaults
+    auto five = variants.get({ gl::specialization_constant { 0, 5 } });
+    ASSERT_NE(five, nullptr);
+    EXPECT_EQ(run(five), 5);
+    EXPECT_EQ(run(variants.get({})), 1);
+
+    // the order of the constants does not matter
+    EXPECT_EQ(variants.get({ gl::specialization_constant { 1, 4 }, gl::specialization_constant { 0, 3 } }), seven);
+    EXPECT_EQ(variants.size(), 3);
+    EXPECT_EQ(variants.hits(), 1);
+    EXPECT_EQ(variants.misses(), 3);
+
+    // a missing entry point fails once and is not built again
+    gl::shader_variants broken({ gl::spirv_stage { binary, GL_COMPUTE_SHADER, "missing" } });
+    EXPECT_EQ(broken.get({}), nullptr);
+    EXPECT_EQ(broken.get({}), nullptr);
+    EXPECT_EQ(broken.misses(), 1);
+    glGetError();
+}
+
+TEST(SHADER_BATCH, SHADER_TEST) {
+    std::vector<gl::shader_source> sources {
+        { vertex_shader_source, GL_VERTEX_SHADER },
+        { fragment_shader_source, GL_FRAGMENT_SHADER }
+    };
+    std::vector<gl::shader_source> broken_sources {
+        { vertex_shader_source, GL_VERTEX_SHADER },
+        { "#version 330 core\nvoid main() { broken }\n", GL_FRAGMENT_SHADER }
+    };
+    std::vector<gl::shader_program> programs(3);
+
+    gl::shader_batch batch;
+    auto index1 = batch.add(programs[0], sources);
+    auto index2 = batch.add(programs[1], broken_sources);
+    auto index3 = batch.add(programs[2], sources);
+    EXPECT_EQ(batch.size(), 3);
+    EXPECT_EQ(batch.pending(), 3);
+
+    while(!batch.poll());
+    EXPECT_EQ(batch.pending(), 0);
+    EXPECT_EQ(batch.status(index1), gl::program_status::ready);
+    EXPECT_EQ(batch.status(index2), gl::program_status::failed);
+    EXPECT_EQ(batch.status(index3), gl::program_status::ready);
+    EXPECT_TRUE(batch.log(index1).empty());
+    EXPECT_FALSE(batch.log(index2).empty());
+
+    // move-assigning over a batch with pending work deletes its shaders
+    gl::shader_program pending_program;
+    gl::shader_batch pending_batch;
+    pending_batch.add(pending_program, sources);
+    GLuint shaders[2];
+    GLsizei count = 0;
+    glGetAttachedShaders(pending_program.handle(), 2, &count, shaders);
+    ASSERT_EQ(count, 2);
+    pending_batch = std::move(batch);
+    EXPECT_EQ(pending_batch.size(), 3);
+    EXPECT_EQ(pending_batch.pending(), 0);
+    EXPECT_EQ(batch.size(), 0);
+    for(auto shader : shaders) {
+        GLint deleted = GL_FALSE;
+        glGetShaderiv(shader, GL_DELETE_STATUS, &deleted);
+        EXPECT_EQ(deleted, GL_TRUE);
+    }
+}
+
+TEST(PROGRAM_REFLECTION, SHADER_TEST) {
+    using namespace gl::literals;
+    gl::shader_program program;
+    program.add_shader(R"(
+#version 430 core
+layout(location = 0) in vec3 position;
+layout(location = 2) in vec2 uv;
+uniform mat4 mvp;
+uniform vec4 tint;
+uniform float weights[2];
+layout(std140, binding = 1) uniform material {
+    vec4 albedo;
+    float roughness;
+};
+layout(std430, binding = 3) buffer particles {
+    vec4 points[];
+};
+out vec4 color;
+void main() {
+    gl_Position = mvp * vec4(position, 1.0) + points[0];
+    color = tint * albedo * (weights[0] + weights[1] + roughness) * vec4(uv, 1.0, 1.0);
+}
+)", GL_VERTEX_SHADER);
+    program.add_shader(R"(
+#version 430 core
+in vec4 color;
+out vec4 frag;
+void main() {
+    frag = color;
+}
+)", GL_FRAGMENT_SHADER);
+    ASSERT_TRUE(program.link());
+
+    // locations agree with the driver
+    EXPECT_EQ(program.uniform_location("mvp"), glGetUniformLocation(program.handle(), "mvp"));
+    EXPECT_EQ(program.uniform_location("tint"_name), glGetUniformLocation(program.handle(), "tint"));
+    EXPECT_EQ(program.uniform_location("weights"), glGetUniformLocation(program.handle(), "weights"));
+    EXPECT_EQ(program.uniform_location("weights[0]"), glGetUniformLocation(program.handle(), "weights"));
+    EXPECT_EQ(program.uniform_location("unknown"), -1);
+    EXPECT_EQ(program.attribute_location("position"_name), 0);
+    EXPECT_EQ(program.attribute_location("uv"), 2);
+
+    // blocks
+    auto material = program.uniform_block("material");
+    ASSERT_NE(material, nullptr);
+    EXPECT_EQ(material->location, 1);
+    EXPECT_EQ(material->data_size, 32);
+    auto particles = program.storage_block("particles"_name);
+    ASSERT_NE(particles, nullptr);
+    EXPECT_EQ(particles->location, 3);
+    auto roughness = program.find_resource(GL_UNIFORM, gl::name_hash("roughness"));
+    ASSERT_NE(roughness, nullptr);
+    EXPECT_EQ(roughness->offset, 16);
+    EXPECT_EQ(roughness->block_index, material->index);
+
+    // setters without use()
+    glm::vec4 tint(1, 2, 3, 4);
+    program.program_uniform("tint"_name, tint);
+    GLfloat values[4];
+    glGetUniformfv(program.handle(), program.uniform_location("tint"), values);
+    for(int i = 0; i < 4; i++) {
+        EXPECT_EQ(values[i], tint[i]);
+    }
+    GLfloat weights[] = { 5, 6 };
+    program.program_uniform(program.uniform_location("weights"), weights, 2);
+    glGetUniformfv(program.handle(), program.uniform_location("weights") + 1, values);
+    EXPECT_EQ(values[0], 6);
+
+    // setters on the program in use
+    glm::mat4 mvp(2.0f);
+    program.use();
+    program.uniform("mvp"_name, mvp);
+    program.unuse();
+    GLfloat matrix[16];
+    glGetUniformfv(program.handle(), program.uniform_location("mvp"), matrix);
+    EXPECT_EQ(matrix[0], 2);
+    EXPECT_EQ(matrix[1], 0);
+    EXPECT_EQ(matrix[15], 2);
+
+    // names with the same hash are told apart by the string lookups
+    static_assert("u31992"_name == "u605430"_name);
+    gl::shader_program colliding;
+    colliding.add_shader(R"(
+#version 430 core
+uniform float u31992;
+uniform float u605430;
+void main() {
+    gl_Position = vec4(u31992, u605430, 0.0, 1.0);
+}
+)", GL_VERTEX_SHADER);
+    ASSERT_TRUE(colliding.link());
+    EXPECT_EQ(colliding.uniform_location("u31992"), glGetUniformLocation(colliding.handle(), "u31992"));
+    EXPECT_EQ(colliding.uniform_location("u605430"), glGetUniformLocation(colliding.handle(), "u605430"));
+    EXPECT_NE(colliding.uniform_location("u31992"), colliding.uniform_location("u605430"));
+    EXPECT_EQ(colliding.uniform_location("u1"), -1);
+}
+
+TEST(STATE_CACHE, STATE_TEST) {
+    std::vector<float> data { 1, 2, 3 };
+    gl::vertex_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo1(data.begin(), data.end());
+    gl::vertex_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo2(data.begin(), data.end());
+    auto& state = gl::current_state();
+
+    // redundant buffer binds are skipped
+    vbo1.bind();
+    state.reset_statistics();
+    vbo1.bind();
+    vbo1.bind();
+    EXPECT_EQ(state.issued(), 0);
+    EXPECT_EQ(state.elided(), 2);
+    vbo2.bind();
+    EXPECT_EQ(state.issued(), 1);
+    EXPECT_EQ(state.buffer(GL_ARRAY_BUFFER), vbo2.handle());
+    GLint binding;
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &binding);
+    EXPECT_EQ(binding, vbo2.handle());
+
+    // bind scope restores the previous vertex array instead of 0
+    gl::vertex_array vao1, vao2;
+    vao1.bind();
+    if(auto ctx = vao2.get_bind()) {
+        EXPECT_EQ(state.vertex_array(), vao2.handle());
+    }
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &binding);
+    EXPECT_EQ(binding, vao1.handle());
+    EXPECT_EQ(state.vertex_array(), vao1.handle());
+
+    // programs
+    gl::shader_program program;
+    program.add_shader(vertex_shader_source, GL_VERTEX_SHADER);
+    program.add_shader(fragment_shader_source, GL_FRAGMENT_SHADER);
+    ASSERT_TRUE(program.link());
+    program.use();
+    state.reset_statistics();
+    program.use();
+    program.unuse();
+    program.unuse();
+    EXPECT_EQ(state.issued(), 1);
+    EXPECT_EQ(state.elided(), 2);
+
+    // raw GL calls require invalidation
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    state.invalidate();
+    vbo2.bind();
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &binding);
+    EXPECT_EQ(binding, vbo2.handle());
+    vao1.unbind();
+}
+
+TEST(DELETION_QUEUE, STATE_TEST) {
+    auto& queue = gl::current_deletion_queue();
+    queue.set_deferred(true);
+    queue.reset_statistics();
+    std::vector<float> data { 1, 2, 3, 4 };
+    GLuint handle;
+    {
+        gl::vertex_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo(data.begin(), data.end());
+        handle = vbo.handle();
+        gl::vertex_array vao;
+        gl::shader_program program;
+    }
+
+    // nothing is deleted until the frame has completed
+    EXPECT_EQ(queue.pending(), 3);
+    EXPECT_EQ(queue.deleted(), 0);
+    EXPECT_TRUE(glIsBuffer(handle));
+    queue.end_frame();
+    glFinish();
+    queue.collect();
+    EXPECT_EQ(queue.pending(), 0);
+    EXPECT_EQ(queue.deleted(), 2);
+    EXPECT_EQ(queue.recyclable(), 1);
+
+    // a buffer of the same size and usage takes over the retired handle
+    std::vector<float> data2 { 5, 6, 7, 8 };
+    gl::vertex_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo1(data2.begin(), data2.end());
+    EXPECT_EQ(vbo1.handle(), handle);
+    EXPECT_EQ(queue.recycled(), 1);
+    std::vector<float> buffer(data2.size());
+    vbo1.get(0, buffer.begin(), buffer.end());
+    for(std::size_t i = 0; i < data2.size(); i++) {
+        EXPECT_EQ(buffer[i], data2[i]);
+    }
+
+    // a different size does not match
+    gl::vertex_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo2(std::size_t(8));
+    EXPECT_NE(vbo2.handle(), handle);
+    EXPECT_EQ(queue.recycled(), 1);
+
+    // move assignment retires the overwritten buffer
+    vbo1 = std::move(vbo2);
+    EXPECT_EQ(queue.pending(), 1);
+    queue.flush();
+    EXPECT_EQ(queue.pending(), 0);
+    EXPECT_FALSE(glIsBuffer(handle));
+
+    queue.set_deferred(false);
+}
+
+#ifdef GLPLUSPLUS_PROFILE
+TEST(PROFILER, STATE_TEST) {
+    auto& profiler = gl::current_profiler();
+    profiler.reset();
+
+    std::vector<float> data { 1, 2, 3, 4 };
+    std::vector<float> buffer(data.size());
+    {
+        GLPLUSPLUS_PROFILE_ZONE("upload");
+        gl::vertex_buffer<gl::buffer_trait<float, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo(data.begin(), data.end());
+        {
+            GLPLUSPLUS_PROFILE_ZONE("modify");
+            vbo.modify(0, data.begin(), data.begin() + 2);
+        }
+        vbo.get(0, buffer.begin(), buffer.end());
+    }
+    EXPECT_EQ(profiler.counters().uploaded_bytes, 6 * sizeof(float));
+    EXPECT_EQ(profiler.counters().read_bytes, 4 * sizeof(float));
+
+    // results are read back only after the latency frames
+    profiler.end_frame();
+    EXPECT_TRUE(profiler.zones().empty());
+    glFinish();
+    profiler.end_frame();
+    profiler.end_frame();
+    ASSERT_EQ(profiler.zones().size(), 2);
+    EXPECT_STREQ(profiler.zones()[0].name, "upload");
+    EXPECT_EQ(profiler.zones()[0].depth, 0);
+    EXPECT_STREQ(profiler.zones()[1].name, "modify");
+    EXPECT_EQ(profiler.zones()[1].depth, 1);
+    EXPECT_GE(profiler.zones()[0].end, profiler.zones()[0].begin);
+    EXPECT_GE(profiler.zones()[1].begin, profiler.zones()[0].begin);
+
+    std::ostringstream trace;
+    profiler.write_chrome_trace(trace);
+    EXPECT_NE(trace.str().find("\"name\":\"upload\""), std::string::npos);
+    EXPECT_NE(trace.str().find("\"uploaded_bytes\":24"), std::string::npos);
+
+    profiler.release();
+    profiler.reset();
+}
+#endif
+
+struct layout_vertex {
+    glm::vec3 position;
+    glm::vec2 uv;
+    GLint id;
+};
+using test_layout = gl::vertex_layout<layout_vertex,
+        gl::vertex_attribute<glm::vec3, offsetof(layout_vertex, position), 0>,
+        gl::vertex_attribute<glm::vec2, offsetof(layout_vertex, uv), 1, GL_TRUE>,
+        gl::vertex_attribute<GLint, offsetof(layout_vertex, id), 3>>;
+
+TEST(VERTEX_LAYOUT, VERTEX_ARRAY_TEST) {
+    static_assert(test_layout::stride == sizeof(layout_vertex));
+    static_assert(test_layout::attribute_count == 3);
+    std::vector<layout_vertex> data(4);
+    gl::vertex_buffer<gl::buffer_trait<layout_vertex, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo1(data.begin(), data.end());
+    gl::vertex_buffer<gl::buffer_trait<layout_vertex, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo2(data.begin(), data.end());
+
+    // configure a whole vertex array in one call
+    gl::vertex_array vao;
+    test_layout::apply(vao, vbo1);
+    GLint values[4];
+    if(auto ctx = vao.get_bind()) {
+        glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_SIZE, values);
+        glGetVertexAttribiv(1, GL_VERTEX_ATTRIB_ARRAY_NORMALIZED, values + 1);
+        glGetVertexAttribiv(3, GL_VERTEX_ATTRIB_ARRAY_INTEGER, values + 2);
+        glGetVertexAttribiv(3, GL_VERTEX_ATTRIB_RELATIVE_OFFSET, values + 3);
+    }
+    EXPECT_EQ(values[0], 3);
+    EXPECT_EQ(values[1], GL_TRUE);
+    EXPECT_EQ(values[2], GL_TRUE);
+    EXPECT_EQ(values[3], offsetof(layout_vertex, id));
+
+    // identical layouts share one vertex array and switch only the buffer
+    gl::shared_vertex_array<test_layout> shared;
+    shared.bind(vbo1);
+    EXPECT_EQ(gl::current_state().vertex_array(), shared.array().handle());
+    gl::current_state().reset_statistics();
+    shared.bind(vbo2);
+    EXPECT_EQ(gl::current_state().issued(), 0);
+    GLint binding, stride;
+    glGetIntegeri_v(GL_VERTEX_BINDING_BUFFER, 0, &binding);
+    glGetIntegeri_v(GL_VERTEX_BINDING_STRIDE, 0, &stride);
+    EXPECT_EQ(binding, vbo2.handle());
+    EXPECT_EQ(stride, sizeof(layout_vertex));
+    shared.array().unbind();
+}
+
+TEST(MESH_FILE, BUFFER_TEST) {
+    auto path = (std::filesystem::temp_directory_path() / "gl++_mesh_file_test.bin").string();
+    std::vector<layout_vertex> vertices(1000);
+    for(std::size_t i = 0; i < vertices.size(); i++) {
+        vertices[i] = layout_vertex { glm::vec3(i, i + 1, i + 2), glm::vec2(i, -1), static_cast<GLint>(i) };
+    }
+    std::vector<GLushort> indices(3000);
+    for(std::size_t i = 0; i < indices.size(); i++) indices[i] = i % vertices.size();
+    // small chunks so both arrays span several of them
+    ASSERT_TRUE((gl::write_mesh_file<test_layout, GLushort>(path, vertices, indices, 4096)));
+
+    gl::mesh_file file(path);
+    ASSERT_TRUE(file.is_open());
+    EXPECT_TRUE(file.matches<test_layout>());
+    EXPECT_EQ(file.description().vertex_count, vertices.size());
+    EXPECT_EQ(file.description().index_type, GL_UNSIGNED_SHORT);
+    EXPECT_EQ(file.vertex_bytes(), vertices.size() * sizeof(layout_vertex));
+    EXPECT_EQ(file.index_bytes(), indices.size() * sizeof(GLushort));
+    EXPECT_GT(file.chunks().size(), 4);
+
+    using buffers_type = gl::mesh_buffers<layout_vertex, GLushort>;
+    ASSERT_TRUE(buffers_type::compatible(file));
+    EXPECT_FALSE((gl::mesh_buffers<layout_vertex, GLuint>::compatible(file)));
+    buffers_type buffers(file);
+    EXPECT_EQ(buffers.loaded_chunks(), 0);
+    // on demand: only the chunk holding the first vertices
+    EXPECT_EQ(buffers.load_vertices(0, 10), 1);
+    EXPECT_EQ(buffers.load_vertices(0, 10), 0);
+    EXPECT_TRUE(buffers.loaded(0));
+    layout_vertex first;
+    buffers.vertices().get(5, &first, 1);
+    EXPECT_EQ(first.id, 5);
+    EXPECT_EQ(first.position.y, 6.0f);
+
+    buffers.load_all();
+    EXPECT_TRUE(buffers.complete());
+    std::vector<layout_vertex> loaded_vertices(vertices.size());
+    std::vector<GLushort> loaded_indices(indices.size());
+    buffers.vertices().get(0, loaded_vertices.begin(), loaded_vertices.end());
+    buffers.indices().get(0, loaded_indices.begin(), loaded_indices.end());
+    EXPECT_EQ(std::memcmp(loaded_vertices.data(), vertices.data(), file.vertex_bytes()), 0);
+    EXPECT_EQ(loaded_indices, indices);
+
+    // a file from another version is rejected
+    file.close();
+    {
+        std::fstream stream(path, std::ios::binary | std::ios::in | std::ios::out);
+        stream.seekp(4);
+        std::uint32_t version = gl::mesh_file::version + 1;
+        stream.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    }
+    EXPECT_FALSE(file.open(path));
+    EXPECT_FALSE(gl::mesh_file(path + ".missing").is_open());
+    std::filesystem::remove(path);
+}
+
+static const char* color_vertex_shader_source = R"(
+#version 430 core
+layout(location = 0) in vec2 position;
+void main() {
+    gl_Position = vec4(position, 0.0, 1.0);
+}
+)";
+
+static const char* color_fragment_shader_source = R"(
+#version 430 core
+uniform vec4 color;
+out vec4 frag;
+void main() {
+    frag = color;
+}
+)";
+
+TEST(DRAW_BATCH, DRAW_TEST) {
+    using namespace gl::literals;
+    using layout = gl::vertex_layout<glm::vec2, gl::vertex_attribute<glm::vec2, 0, 0>>;
+    framebuffer_fixture framebuffer(4, 1);
+    gl::shader_program program;
+    program.add_shader(color_vertex_shader_source, GL_VERTEX_SHADER);
+    program.add_shader(color_fragment_shader_source, GL_FRAGMENT_SHADER);
+    ASSERT_TRUE(program.link());
+
+    gl::draw_batch<layout> batch;
+    // left half as indexed quad, right half as two triangles
+    std::vector<glm::vec2> left_vertices { { -1, -1 }, { 0, -1 }, { 0, 1 }, { -1, 1 } };
+    std::vector<GLuint> left_indices { 0, 1, 2, 0, 2, 3 };
+    std::vector<glm::vec2> right_vertices { { 0, -1 }, { 1, -1 }, { 1, 1 }, { 0, -1 }, { 1, 1 }, { 0, 1 } };
+    auto left = batch.add_mesh(left_vertices, left_indices);
+    auto right = batch.add_mesh(right_vertices);
+    EXPECT_TRUE(left.indexed);
+    EXPECT_FALSE(right.indexed);
+    EXPECT_EQ(right.first, 4);
+    EXPECT_EQ(batch.vertices().size(), 10);
+
+    batch.draw(1, right);
+    batch.draw(0, left);
+    program.use();
+    std::vector<std::uint64_t> order;
+    batch.submit(GL_TRIANGLES, [&](std::uint64_t key) {
+        order.push_back(key);
+        program.uniform("color"_name, key == 0 ? glm::vec4(1, 0, 0, 1) : glm::vec4(0, 1, 0, 1));
+    });
+    program.unuse();
+    batch.array().unbind();
+    EXPECT_EQ(batch.draw_calls(), 2);
+    ASSERT_EQ(order.size(), 2);
+    EXPECT_EQ(order[0], 0);
+    EXPECT_EQ(order[1], 1);
+
+    auto pixels = framebuffer.pixels();
+    EXPECT_EQ(pixels[0], 255);
+    EXPECT_EQ(pixels[1], 0);
+    EXPECT_EQ(pixels[3 * 4 + 0], 0);
+    EXPECT_EQ(pixels[3 * 4 + 1], 255);
+
+    // submitting again without draws does nothing
+    batch.submit(GL_TRIANGLES);
+    EXPECT_EQ(batch.draw_calls(), 0);
+
+    // later frames write their commands into the next regions, then a larger one into new storage
+    for(int frame = 0; frame < 5; frame++) {
+        batch.draw(0, right);
+        if(frame == 4) batch.draw(0, left);
+        program.use();
+        batch.submit(GL_TRIANGLES, [&](std::uint64_t) {
+            program.uniform("color"_name, frame % 2 == 0 ? glm::vec4(0, 0, 1, 1) : glm::vec4(1, 1, 1, 1));
+        });
+        program.unuse();
+        batch.array().unbind();
+        EXPECT_EQ(batch.draw_calls(), frame == 4 ? 2 : 1);
+        pixels = framebuffer.pixels();
+        EXPECT_EQ(pixels[3 * 4 + 0], frame % 2 == 0 ? 0 : 255);
+        EXPECT_EQ(pixels[3 * 4 + 2], 255);
+    }
+    EXPECT_EQ(pixels[0], 0);
+    EXPECT_EQ(pixels[2], 255);
+}
+
+static const char* instanced_vertex_shader_source = R"(
+#version 430 core
+layout(location = 0) in vec2 position;
+layout(location = 1) in mat4 transform;
+layout(location = 5) in vec4 color;
+out vec4 instance_color;
+void main() {
+    gl_Position = transform * vec4(position, 0.0, 1.0);
+    instance_color = color;
+}
+)";
+
+static const char* instanced_fragment_shader_source = R"(
+#version 430 core
+in vec4 instance_color;
+out vec4 frag;
+void main() {
+    frag = instance_color;
+}
+)";
+
+TEST(INSTANCED_DRAW, DRAW_TEST) {
+    struct instance {
+        glm::mat4 transform;
+        glm::vec4 color;
+    };
+    static_assert(gl::attribute_locations<glm::mat4> == 4);
+    static_assert(gl::attribute_components<glm::mat4> == 4);
+    static_assert(gl::attribute_locations<glm::mat<4, 4, double>> == 8);
+    framebuffer_fixture framebuffer(4, 1);
+    gl::shader_program program;
+    program.add_shader(instanced_vertex_shader_source, GL_VERTEX_SHADER);
+    program.add_shader(instanced_fragment_shader_source, GL_FRAGMENT_SHADER);
+    ASSERT_TRUE(program.link());
+
+    // one quad on the right half, moved by the per-instance transform
+    std::vector<glm::vec2> quad { { 0, -1 }, { 1, -1 }, { 1, 1 }, { 0, -1 }, { 1, 1 }, { 0, 1 } };
+    gl::vertex_buffer<gl::buffer_trait<glm::vec2, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo(quad.begin(), quad.end());
+    gl::instance_buffer<instance> instances;
+    EXPECT_EQ(instances.capacity(), 0);
+    std::vector<instance> data(2, instance { glm::mat4(1.0f), glm::vec4(0.0f, 1.0f, 0.0f, 1.0f) });
+    data[0].transform[3][0] = -1.0f;
+    data[0].color = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+    instances.update(data);
+    EXPECT_EQ(instances.size(), 2);
+    auto handle = instances.handle();
+
+    gl::vertex_array vao;
+    vbo.vertex_pointer(vao, 0, GL_FALSE, gl::this_select);
+    instances.vertex_pointer(vao, 1, GL_FALSE, &instance::transform);
+    instances.vertex_pointer(vao, 5, GL_FALSE, &instance::color);
+
+    GLint divisors[3], enabled, offset;
+    vao.bind();
+    glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_DIVISOR, divisors);
+    glGetVertexAttribiv(4, GL_VERTEX_ATTRIB_ARRAY_DIVISOR, divisors + 1);
+    glGetVertexAttribiv(5, GL_VERTEX_ATTRIB_ARRAY_DIVISOR, divisors + 2);
+    glGetVertexAttribiv(4, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &enabled);
+    glGetVertexAttribiv(4, GL_VERTEX_ATTRIB_RELATIVE_OFFSET, &offset);
+    EXPECT_EQ(divisors[0], 0);
+    EXPECT_EQ(divisors[1], 1);
+    EXPECT_EQ(divisors[2], 1);
+    EXPECT_EQ(enabled, GL_TRUE);
+    // the last column of the matrix, relative to the binding in DSA and to the pointer otherwise
+    EXPECT_EQ(offset, gl::direct_state_access() ? 3 * sizeof(glm::vec4) : 0);
+
+    program.use();
+    glDrawArraysInstanced(GL_TRIANGLES, 0, quad.size(), instances.size());
+    auto pixels = framebuffer.pixels();
+    EXPECT_EQ(pixels[0], 255);
+    EXPECT_EQ(pixels[1], 0);
+    EXPECT_EQ(pixels[3 * 4 + 0], 0);
+    EXPECT_EQ(pixels[3 * 4 + 1], 255);
+
+    // growing keeps the handle, so the vertex array still draws from it
+    data.push_back(data[1]);
+    data[0].color = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    instances.update(data);
+    EXPECT_EQ(instances.handle(), handle);
+    EXPECT_EQ(instances.capacity(), 4);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, quad.size(), instances.size());
+    program.unuse();
+    vao.unbind();
+    pixels = framebuffer.pixels();
+    EXPECT_EQ(pixels[0], 0);
+    EXPECT_EQ(pixels[2], 255);
+}
+
+static const char* block_fragment_shader_source = R"(
+#version 430 core
+layout(std140) uniform Material {
+    vec4 color;
+    vec3 tint;
+    float strength;
+    vec2 offsets[2];
+    mat3 basis;
+};
+layout(std430, binding = 0) buffer Lights {
+    vec3 direction;
+    float intensity;
+    vec2 weights[3];
+    mat3 rotation;
+} lights;
+out vec4 frag;
+void main() {
+    frag = color + vec4(tint * strength * offsets[1].x * basis[0].x, 0.0);
+    lights.intensity = lights.weights[2].y + lights.rotation[1].z + lights.direction.x;
+}
+)";
+
+TEST(UNIFORM_BLOCK, DRAW_TEST) {
+    using namespace gl::literals;
+    using material_block = gl::std140_block<glm::vec4, glm::vec3, float, glm::vec2[2], glm::mat3>;
+    using lights_block = gl::std430_block<glm::vec3, float, glm::vec2[3], glm::mat3>;
+    // std140 pads array elements and matrix columns to a vec4, std430 only to their own alignment
+    static_assert(material_block::offset<2> == 28);
+    static_assert(material_block::offset<3> == 32);
+    static_assert(material_block::offset<4> == 64);
+    static_assert(material_block::size == 112);
+    static_assert(lights_block::offset<2> == 16);
+    static_assert(lights_block::offset<3> == 48);
+    static_assert(lights_block::size == 96);
+    static_assert(gl::std140_block<float, material_block, float>::offset<2> == 128);
+    static_assert(gl::std430_block<float, gl::std430_block<float>, float>::offset<2> == 8);
+
+    struct material {
+        glm::vec4 color;
+        glm::vec3 tint;
+        float strength;
+        glm::vec4 offsets[2];
+        glm::vec4 basis[3];
+    };
+    static_assert(offsetof(material, strength) == material_block::offset<2>);
+    static_assert(offsetof(material, basis) == material_block::offset<4>);
+    static_assert(sizeof(material) == material_block::size);
+
+    framebuffer_fixture framebuffer(1, 1);
+    gl::shader_program program;
+    program.add_shader(color_vertex_shader_source, GL_VERTEX_SHADER);
+    program.add_shader(block_fragment_shader_source, GL_FRAGMENT_SHADER);
+    ASSERT_TRUE(program.link());
+    EXPECT_TRUE(gl::match_block_layout<material_block>(program, "Material"_name,
+            { "color"_name, "tint"_name, "strength"_name, "offsets"_name, "basis"_name }));
+    EXPECT_TRUE(gl::match_block_layout<lights_block>(program, "Lights"_name,
+            { "Lights.direction"_name, "Lights.intensity"_name, "Lights.weights"_name, "Lights.rotation"_name }));
+    // the members out of order
+    EXPECT_FALSE(gl::match_block_layout<material_block>(program, "Material"_name,
+            { "color"_name, "strength"_name, "tint"_name, "offsets"_name, "basis"_name }));
+    EXPECT_FALSE(gl::match_block_layout<lights_block>(program, "Material"_name,
+            { "Lights.direction"_name, "Lights.intensity"_name, "Lights.weights"_name, "Lights.rotation"_name }));
+
+    std::vector<glm::vec2> quad { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, -1 }, { 1, 1 }, { -1, 1 } };
+    gl::vertex_buffer<gl::buffer_trait<glm::vec2, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> vbo(quad.begin(), quad.end());
+    gl::vertex_buffer<gl::buffer_trait<float, GL_SHADER_STORAGE_BUFFER, GL_STATIC_DRAW>> ssbo(lights_block::size / sizeof(float));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssbo.handle());
+    gl::vertex_array vao;
+    vbo.vertex_pointer(vao, 0, GL_FALSE, gl::this_select);
+    glUniformBlockBinding(program.handle(), program.uniform_block("Material"_name)->index, 1);
+
+    gl::uniform_allocator allocator(1000);
+    EXPECT_EQ(allocator.frame_size() % allocator.alignment(), 0);
+    EXPECT_FALSE(allocator.push(material {}));
+    material red {}, green {};
+    red.color = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+    green.color = glm::vec4(0.0f, 1.0f, 0.0f, 1.0f);
+    program.use();
+    vao.bind();
+    std::vector<GLubyte> colors;
+    for(int frame = 0; frame < 4; frame++) {
+        allocator.begin_frame();
+        auto first = allocator.push(red);
+        auto second = allocator.push(green);
+        ASSERT_TRUE(first && second);
+        EXPECT_EQ(first->offset % allocator.alignment(), 0);
+        EXPECT_EQ(second->offset % allocator.alignment(), 0);
+        EXPECT_GE(second->offset - first->offset, sizeof(material));
+        for(const auto& range : { *first, *second }) {
+            gl::uniform_allocator::bind(1, range);
+            glDrawArrays(GL_TRIANGLES, 0, quad.size());
+            auto pixels = framebuffer.pixels();
+            colors.insert(colors.end(), pixels.begin(), pixels.begin() + 2);
+        }
+        // full frames refuse more blocks instead of spilling into the next one
+        while(allocator.push(red));
+        EXPECT_LE(allocator.used(), allocator.frame_size());
+        allocator.end_frame();
+    }
+    vao.unbind();
+    program.unuse();
+    for(std::size_t i = 0; i < colors.size(); i += 4) {
+        EXPECT_EQ(colors[i], 255);
+        EXPECT_EQ(colors[i + 1], 0);
+        EXPECT_EQ(colors[i + 2], 0);
+        EXPECT_EQ(colors[i + 3], 255);
+    }
+}
+
+static const char* feedback_vertex_shader_source = R"(
+#version 430 core
+layout(location = 0) in vec2 position;
+out vec2 moved;
+void main() {
+    moved = position * 2.0 + 1.0;
+}
+)";
+
+TEST(TRANSFORM_FEEDBACK, DRAW_TEST) {
+    // nothing is rasterized, but draws still need a complete framebuffer
+    framebuffer_fixture framebuffer(1, 1);
+    gl::shader_program program;
+    program.add_shader(feedback_vertex_shader_source, GL_VERTEX_SHADER);
+    ASSERT_TRUE(program.transform_feedback_varyings({ "moved" }));
+    ASSERT_TRUE(program.link());
+
+    using vec2_buffer = gl::vertex_buffer<gl::buffer_trait<glm::vec2, GL_ARRAY_BUFFER, GL_STATIC_DRAW>>;
+    std::vector<glm::vec2> points(10);
+    for(std::size_t i = 0; i < points.size(); i++) points[i] = glm::vec2(i, -float(i));
+    vec2_buffer source(points.begin(), points.end());
+    vec2_buffer first(points.size()), second(points.size());
+    gl::vertex_array source_vao, first_vao;
+    source.vertex_pointer(source_vao, 0, GL_FALSE, gl::this_select);
+    first.vertex_pointer(first_vao, 0, GL_FALSE, gl::this_select);
+
+    gl::transform_feedback feedback;
+    feedback.capture(0, first);
+    program.use();
+    source_vao.bind();
+    feedback.run(GL_POINTS, [&] { glDrawArrays(GL_POINTS, 0, points.size()); });
+    EXPECT_FALSE(glIsEnabled(GL_RASTERIZER_DISCARD));
+    EXPECT_EQ(feedback.primitives_written(), points.size());
+    GLuint count = 0;
+    EXPECT_TRUE(feedback.primitives_written(count));
+    EXPECT_EQ(count, points.size());
+    std::vector<glm::vec2> result(points.size());
+    first.get(result.begin(), result.end());
+    for(std::size_t i = 0; i < points.size(); i++) {
+        EXPECT_EQ(result[i].x, points[i].x * 2 + 1);
+        EXPECT_EQ(result[i].y, points[i].y * 2 + 1);
+    }
+
+    // the count of the second pass comes from the first one and is written to a buffer by the GPU
+    gl::transform_feedback chained;
+    // setting up one object keeps another one bound
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, feedback.handle());
+    chained.capture(0, second);
+    GLint bound = 0;
+    glGetIntegerv(GL_TRANSFORM_FEEDBACK_BINDING, &bound);
+    EXPECT_EQ(bound, feedback.handle());
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
+    first_vao.bind();
+    chained.run(GL_POINTS, [&] { feedback.draw(GL_POINTS); });
+    gl::vertex_buffer<gl::buffer_trait<GLuint, GL_ARRAY_BUFFER, GL_STATIC_DRAW>> written(2);
+    chained.primitives_written(written.handle(), sizeof(GLuint));
+    first_vao.unbind();
+    program.unuse();
+    std::vector<GLuint> counts(2);
+    written.get(counts.begin(), counts.end());
+    EXPECT_EQ(counts[1], points.size());
+    second.get(result.begin(), result.end());
+    EXPECT_EQ(result[3].x, (points[3].x * 2 + 1) * 2 + 1);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
+    // llvmpipe on a single core rasterizes inside glFenceSync, so no fence would ever be pending
+    setenv("LP_NUM_THREADS", "2", 0);
 
     if(glfwInit() == GLFW_FALSE) {
         throw std::runtime_error("failed to initialize GLFW");